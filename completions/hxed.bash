@@ -6,7 +6,7 @@ _hxed()
     _init_completion -n = || return
 
     local opts modes heatmaps
-    opts="-f --file -m --mode -hm --heatmap -w --width -g --grouping -a --ascii -c --color -s --string -e --entropy -th --toggle-header -sz --skip-zero -re --reverse -o --offset -l --limit -r --read-size -se --search -p --pager -ro --raw --show-config -h --help -v --version"
+    opts="-f --file -m --mode -hm --heatmap -w --width -g --grouping -a --ascii -c --color -s --string -e --entropy -th --toggle-header -sz --skip-zero -sq --squeeze -re --reverse -o --offset -l --limit -r --read-size --tail --range -se --search -p --pager -ro --raw --jobs --stats-only --top --entropy-map --segments --strings --dedup-report --hash --cache --diff --make-patch --apply-patch --snapshot --since --locate --follow --tail-follow --show-config -h --help -v --version"
     modes="0 1 2 3 hex bin oct dec"
     heatmaps="adaptiv fixed none"
 
@@ -23,7 +23,11 @@ _hxed()
             COMPREPLY=( $(compgen -W "$heatmaps" -- "$cur") )
             return
             ;;
-        -w|--width|-g|--grouping|-o|--offset|-l|--limit|-r|--read-size)
+        -w|--width|-g|--grouping|-o|--offset|-l|--limit|-r|--read-size|--tail|--range|--top|--jobs)
+            return
+            ;;
+        --hash)
+            COMPREPLY=( $(compgen -W "crc32 crc32c xxh64 sha256" -- "$cur") )
             return
             ;;
         -se|--search)
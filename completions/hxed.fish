@@ -11,13 +11,33 @@ complete -c hxed -s s -l string -d 'Toggle string highlighting'
 complete -c hxed -s e -l entropy -d 'Toggle entropy graph'
 complete -c hxed -o th -l toggle-header -d 'Toggle header/footer and magic-byte detection'
 complete -c hxed -o sz -l skip-zero -d 'Toggle skip-zero lines'
+complete -c hxed -o sq -l squeeze -d 'Toggle collapsing repeated lines'
 complete -c hxed -o re -l reverse -d 'Toggle reverse mode'
 complete -c hxed -s o -l offset -r -d 'Start offset (supports k/M/G)'
 complete -c hxed -s l -l limit -r -d 'Stop at byte position (supports k/M/G)'
 complete -c hxed -s r -l read-size -r -d 'Read at most N bytes (supports k/M/G)'
+complete -c hxed -l tail -r -d 'Dump the last N bytes (supports k/M/G)'
+complete -c hxed -l range -r -d 'Dump len bytes at off (off:len, repeatable)'
 complete -c hxed -o se -l search -r -f -a 'a: x: d: b:' -d 'Search pattern'
 complete -c hxed -s p -l pager -d 'Toggle pager output'
 complete -c hxed -o ro -l raw -d 'Raw output mode'
+complete -c hxed -l jobs -r -d 'Format the dump on num threads'
+complete -c hxed -l stats-only -d 'Print statistics only (no dump)'
+complete -c hxed -l top -r -d 'Byte values in the stats distribution'
+complete -c hxed -l entropy-map -d 'Print a block entropy map'
+complete -c hxed -l segments -d 'Print a region classification table'
+complete -c hxed -l strings -d 'Extract ASCII and UTF-16LE strings'
+complete -c hxed -l dedup-report -d 'Report duplicate content-defined chunks'
+complete -c hxed -l hash -r -f -a 'crc32 crc32c xxh64 sha256' -d 'Digests of the read range'
+complete -c hxed -l cache -d 'Keep block summaries in a sidecar file'
+complete -c hxed -l diff -r -F -d 'Side-by-side diff of two files'
+complete -c hxed -l make-patch -r -F -d 'Write a binary delta of two files'
+complete -c hxed -l apply-patch -r -F -d 'Apply a binary delta'
+complete -c hxed -l snapshot -r -F -d 'Write a Merkle tree of block hashes'
+complete -c hxed -l since -r -F -d 'Print lines changed since a snapshot'
+complete -c hxed -l locate -r -F -d 'Find the blocks of a file inside another'
+complete -c hxed -l follow -d 'Watch the file and print changed lines'
+complete -c hxed -l tail-follow -d 'Print bytes appended to the file'
 complete -c hxed -l show-config -d 'Show current config and exit'
 complete -c hxed -s h -l help -d 'Show help'
 complete -c hxed -s v -l version -d 'Show version'
@@ -15,13 +15,33 @@ Register-ArgumentCompleter -CommandName hxed -ScriptBlock {
         "-e","--entropy",
         "-th","--toggle-header",
         "-sz","--skip-zero",
+        "-sq","--squeeze",
         "-re","--reverse",
         "-o","--offset",
         "-l","--limit",
         "-r","--read-size",
+        "--tail",
+        "--range",
         "-se","--search",
         "-p","--pager",
         "-ro","--raw",
+        "--jobs",
+        "--stats-only",
+        "--top",
+        "--entropy-map",
+        "--segments",
+        "--strings",
+        "--dedup-report",
+        "--hash",
+        "--cache",
+        "--diff",
+        "--make-patch",
+        "--apply-patch",
+        "--snapshot",
+        "--since",
+        "--locate",
+        "--follow",
+        "--tail-follow",
         "--show-config",
         "-h","--help",
         "-v","--version"
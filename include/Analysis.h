@@ -0,0 +1,42 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Args.h"
+#include "Utils.h"
+
+#define ANALYSIS_CHUNK_SIZE (1 << 20)   // Read size per worker call (1 MiB)
+#define DEFAULT_TOP_N 10
+#define NLOG2N_TABLE_SIZE 65536         // Precomputed n*log2(n) entries for entropy
+#define MAP_COLUMNS 64                  // Cells per entropy map row
+#define MAP_MAX_ROWS 32                 // Rows before blocks are aggregated into cells
+#define MAP_DEFAULT_BLOCK 65536         // Block size for streams of unknown length
+#define SEGMENT_DEFAULT_BLOCK 4096      // Classification unit of the segment report
+
+// Full 256-bin byte histogram of a range.
+typedef struct {
+    uint64_t counts[256];
+    uint64_t total;
+} byte_histogram;
+
+void histogram_update(byte_histogram *hist, const unsigned char *data, size_t len);
+void histogram_merge(byte_histogram *dst, const byte_histogram *src);
+void init_entropy_table(void);
+float entropy_from_counts(const uint64_t counts[256], uint64_t total);
+double histogram_entropy(const byte_histogram *hist);
+void histogram_to_analysis(const byte_histogram *hist, dump_analysis *analysis);
+
+void print_stats_only(options *option);
+void print_entropy_map(options *option);
+void print_segments(options *option);
+
+#endif
@@ -13,6 +13,12 @@
 
 #define MAX_SEARCH_LEN 32
 
+// One region of --range: length bytes from offset.
+typedef struct {
+    size_t offset;
+    size_t length;
+} read_range;
+
 // options (no getopt)
 typedef struct {
     char *filename;        // Path to the file to be read.
@@ -27,14 +33,39 @@ typedef struct {
     bool entropie;         // Future options: -e, --entropy to show entropy graph per line
     bool skip_header;      // Flag to determine if header will be skipped
     bool skip_zero;        // Flag to determine if lines with only zero bytes should be skipped
+    bool squeeze;          // Flag to determine if runs of repeated lines collapse into one * row
     bool reverse_mode;     // Flag to determine if output should be reversed (e.g., hex input to ascii output)
     size_t offset_read;    // Bytes to skip until print
     size_t limit_read;     // Byte to stop reading
     size_t read_size;      // Bytes to read
+    size_t tail_size;      // --tail / negative -o: bytes before the end, 0 = off
     unsigned char *search; // Pointer to the parsed search bytes
     size_t search_len;     // Parsed search length in bytes
     bool pager;            // Flag to determine if output should be sent to a pager (e.g., less)
     bool raw;              // Flag to determine if output should be raw
+    bool stats_only;       // Flag to determine if only the analysis is printed (no dump)
+    int top_n;             // Number of byte values shown in the stats distribution
+    bool entropy_map;      // Flag to determine if a block entropy map is printed instead of the dump
+    size_t map_block;      // Block size for the entropy map (0 = auto)
+    bool segments;         // Flag to determine if a region segmentation report is printed
+    size_t segment_block;  // Block size used to classify regions
+    bool strings;          // Flag to determine if printable strings are extracted instead of the dump
+    size_t strings_min;    // Minimum length of an extracted string
+    bool dedup_report;     // Flag to determine if a duplicate chunk report is printed
+    size_t dedup_avg;      // Average chunk size of the content-defined chunker
+    unsigned int hash_mask; // Digests computed over the read range (HASH_* flags, 0 = none)
+    char *diff_file;       // Second file of --diff (filename is the first), NULL = no diff
+    char *make_patch;      // Target file of --make-patch (filename is the source), NULL = off
+    char *apply_patch;     // Patch file of --apply-patch (filename is the source), NULL = off
+    bool follow;           // Flag to determine if the file is watched and changed lines are printed
+    bool tail_follow;      // Flag to determine if appended bytes are printed as they arrive
+    bool cache;            // Flag to determine if block summaries are kept in a <file>.hxcache sidecar
+    char *snapshot_out;    // Output path of --snapshot, NULL = off
+    char *since_snapshot;  // Snapshot compared by --since, NULL = off
+    char *locate_needle;   // Needle of --locate (filename is the haystack), NULL = off
+    int jobs;              // Threads formatting the dump (1 = sequential)
+    read_range *ranges;    // --range regions in command line order, NULL = -o/-l/-r range
+    size_t range_count;    // Number of --range regions
 } options;
 
 options *get_options(int argc, char *argv[]);
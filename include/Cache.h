@@ -0,0 +1,62 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Analysis.h"
+
+#define CACHE_MAGIC "HXCACHE1"          // First 8 bytes of every sidecar file
+#define CACHE_SUFFIX ".hxcache"         // Sidecar path = input path + suffix
+#define CACHE_BLOCK_SIZE 65536          // Bytes summarized by one cache block
+
+// Identity of the input file. Any difference invalidates the trusted state.
+typedef struct {
+    uint64_t dev;
+    uint64_t inode;
+    uint64_t size;
+    int64_t mtime_sec;
+    int64_t mtime_nsec;
+} cache_key;
+
+// Block states: no summary, summary of an older file version, summary of this version.
+#define CACHE_BLOCK_EMPTY 0
+#define CACHE_BLOCK_STALE 1
+#define CACHE_BLOCK_VALID 2
+
+// Summary of one block. Entropy and the zero ratio are derived from the counts.
+typedef struct {
+    uint64_t digest;            // XXH64 of the block, used to revalidate stale blocks
+    uint32_t state;
+    uint32_t reserved;
+    uint32_t counts[256];
+} cache_block;
+
+typedef struct {
+    cache_key key;
+    bool key_match;             // Sidecar belongs to this exact file version
+    bool magic_valid;
+    unsigned char magic[256];   // Detected signatures, see get_found_magic()
+    size_t block_count;
+    cache_block *blocks;
+    size_t reused;              // Blocks answered from the sidecar
+    size_t computed;            // Blocks read and summarized in this run
+    bool dirty;
+} block_cache;
+
+bool cache_open(block_cache *cache, const char *filename);
+void cache_prepare(block_cache *cache, const char *filename, size_t first, size_t last);
+void cache_histogram(const block_cache *cache, size_t first, size_t last, byte_histogram *hist);
+void cache_magic(block_cache *cache, const char *filename);
+void cache_save(block_cache *cache, const char *filename);
+void cache_close(block_cache *cache);
+
+#endif
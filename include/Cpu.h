@@ -0,0 +1,34 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef CPU_H
+#define CPU_H
+
+#include <stdbool.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define HXED_X86 1
+#endif
+
+// Functions using instructions beyond the build baseline are compiled for their
+// extension with a target attribute and only called after a runtime check.
+#if defined(HXED_X86) && (defined(__GNUC__) || defined(__clang__))
+    #define HXED_TARGET(ext) __attribute__((target(ext)))
+#else
+    #define HXED_TARGET(ext)
+#endif
+
+typedef struct {
+    bool sse42;     // crc32 instruction (CRC32C)
+    bool pclmul;    // carry-less multiply (CRC32 folding)
+    bool sha;       // SHA-NI (SHA-256 rounds)
+} cpu_features;
+
+void detect_cpu_features(void);
+const cpu_features *get_cpu_features(void);
+
+#endif
@@ -0,0 +1,36 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Args.h"
+
+#define DEDUP_DEFAULT_AVG 8192          // Average chunk size of the content-defined chunker
+#define DEDUP_MAX_ENTRIES (1 << 21)     // Upper bound of the chunk index (bounded memory)
+#define DEDUP_OFFSETS 4                 // Offsets remembered per duplicate group
+
+// Parameters of the Gear / FastCDC content-defined chunker.
+typedef struct {
+    uint64_t gear[256];
+    size_t min_size;
+    size_t avg_size;
+    size_t max_size;
+    uint64_t mask_small;    // Stricter mask used before avg_size (fewer early cuts)
+    uint64_t mask_large;    // Looser mask used after avg_size (fewer oversized chunks)
+} cdc_params;
+
+void cdc_init(cdc_params *params, size_t avg_size);
+size_t cdc_next_cut(const cdc_params *params, const unsigned char *data, size_t len, bool eof);
+
+void print_dedup_report(options *option);
+
+#endif
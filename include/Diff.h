@@ -0,0 +1,19 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef DIFF_H
+#define DIFF_H
+
+#include "Args.h"
+
+#define DIFF_BLOCK_SIZE 65536           // Block size of the parallel hash comparison
+#define DIFF_ANCHOR_AVG 4096            // Average anchor chunk size used to resynchronize
+#define DIFF_MAX_ANCHORS (1 << 20)      // Anchors per file, larger inputs get larger chunks
+
+void print_diff(options *option);
+
+#endif
@@ -13,15 +13,36 @@
 #include <stdio.h>
 
 #include "Args.h"
+#include "Hash.h"
+#include "MagicBytes.h"
 
 typedef struct SearchResults SearchResults;
 
+// Growable text buffer, used to collect rendered lines instead of writing them.
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+} text_buffer;
+
+// Run of repeated lines collapsed by --squeeze. Every render state needs its own.
+typedef struct {
+    unsigned char *prev;        // Bytes of the last line that was not a repeat
+    int prev_len;               // -1 = no line yet
+    size_t lines;               // Repeats of prev skipped since it was printed
+    size_t bytes;
+} squeeze_state;
+
 // Utility functions for rendering the hex dump, calculating line widths, 
 // handling color coding, and searching for byte patterns in the input file.
+// All render state lives here, so states on different threads never interfere.
 typedef struct {
     FILE *out;
     options *option;
     const SearchResults *search_results;
+    const unsigned char *data;  // Bytes of the current chunk, render_line reads data + processed
+    text_buffer *capture;       // Rendered lines are appended here instead of written to out, NULL = out
+    squeeze_state *squeeze;     // Repeated lines collapse into one * row, NULL = off
     size_t addr_display;
     size_t search_match_index;
     int addr_width;
@@ -49,19 +70,37 @@ struct SearchResults {
 void append_to_line(char *line, size_t line_size, size_t *line_pos, const char *fmt, ...);
 void append_header_columns(char *line, size_t line_size, size_t *line_pos, const options *option, int column_count);
 void append_magic_summary(char *buffer, size_t buffer_size, size_t *pos);
+void print_report_row(FILE *out, const options *option, const char *label, const char *fmt, ...);
 
 int _calc_visible_columns(const options *option);
 int calc_row_width(const options *option, int addr_width, int column_count);
-int count_found_magic(void);
-void find_magic_bytes_in_stream_header(FILE *file);
 FILE *open_input_file(options *option);
 void render_line(display_state *state, int processed, int line_len);
 int _hex_digits_size_t(size_t value);
+const char *entropy_bar_glyph(float entropy);
+int compare_side_width(const options *option);
+void append_compare_side(char *line, size_t *line_pos, const options *option, size_t first,
+                         const unsigned char *self, size_t len,
+                         const unsigned char *other, size_t other_len);
+void print_digest_rows(FILE *out, const options *option, digest_set *digests);
+void print_digest_lines(FILE *out, const options *option, digest_set *digests);
+
+void squeeze_init(squeeze_state *squeeze, int width);
+void squeeze_copy(squeeze_state *dst, const squeeze_state *src);
+void squeeze_free(squeeze_state *squeeze);
+void squeeze_scan(squeeze_state *squeeze, const options *option, const unsigned char *data, size_t len);
+void flush_squeeze(display_state *state);
+void render_hole(display_state *state, size_t len);
+void render_range_header(display_state *state, size_t index, size_t count, size_t length);
 
 void reset_display_utils_state(void);
-unsigned char *get_display_buffer(void);
+void text_buffer_append(text_buffer *buf, const char *data, size_t len);
+size_t first_search_match(const SearchResults *results, size_t search_len, size_t addr);
+
+// Polled between search chunks; returning true ends the search early.
+typedef bool (*search_stop_fn)(void *ctx);
 
-SearchResults *search_matches(const options *option, FILE *file);
+SearchResults *search_matches(const options *option, FILE *file, search_stop_fn stop, void *stop_ctx);
 void free_search_results(SearchResults *results);
 
 #endif
@@ -13,8 +13,47 @@
 #include <stdio.h>
 #include "Args.h"
 
+#define STDIN_RING_SIZE (1024 * 1024)   // Read-ahead of the stdin reader, whole read units
+
+// Sequential reader over [start, end) of a file or stream, used by the report modes.
+typedef struct {
+    FILE *file;
+    size_t pos;     // Absolute position of the next byte
+    size_t end;     // Absolute end of the range, 0 = until EOF
+} range_reader;
+
+// Read-only memory mapping of a whole file (data is NULL for empty files).
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+    #ifdef _WIN32
+    void *file_handle;
+    void *map_handle;
+    #endif
+} mapped_file;
+
+// Finds holes of sparse files with lseek SEEK_DATA/SEEK_HOLE. Has its own descriptor, so
+// probing never moves the position of the FILE that is read.
+typedef struct {
+    int fd;             // -1 = no hole support, everything is data
+    size_t data_end;    // [.., data_end) is known to be data
+} hole_probe;
+
+bool map_file(const char *path, mapped_file *map);
+void unmap_file(mapped_file *map);
+
+void hole_probe_open(hole_probe *probe, const char *path);
+size_t hole_probe_skip(hole_probe *probe, size_t pos, size_t end);
+void hole_probe_close(hole_probe *probe);
+
+void range_reader_init(range_reader *reader, FILE *file, bool is_stream, size_t start, size_t end);
+size_t range_reader_read(range_reader *reader, unsigned char *buf, size_t cap);
+
+size_t stdin_keep_tail(size_t keep, size_t read_limit);
 void read_stream_to_buffer(int *out_read, FILE *file, size_t read_start, size_t read_limit, unsigned char *_buffer, bool _no_seek);
 void check_file(options *option);
-void find_extrema(unsigned char *_max, unsigned char *_min, unsigned char *line, size_t line_len);
+void find_extrema(unsigned char *_max, unsigned char *_min, const unsigned char *line, size_t line_len);
+int file_seek(FILE *file, size_t pos);
+size_t get_read_end(const options *option);
 
 #endif
@@ -0,0 +1,34 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef FOLLOW_H
+#define FOLLOW_H
+
+#include <stdbool.h>
+
+#include "Args.h"
+
+#define FOLLOW_BLOCK_SIZE 4096          // Change detection granularity (rounded to whole lines)
+#define FOLLOW_RESCAN_MS 1000           // Size/mtime check without an event
+#define FOLLOW_FULL_RESCAN_MS 30000     // Full rescan for mmap writes, which raise no event
+#define FOLLOW_POLL_MS 250              // Rescan interval when inotify is not available
+
+// Change notification for one file: inotify on Linux, plain polling elsewhere.
+typedef struct {
+    int fd;                 // inotify descriptor, -1 = polling
+    int wd;                 // Watch descriptor of the file
+    const char *path;
+} file_watch;
+
+void watch_open(file_watch *watch, const char *path);
+bool watch_wait(file_watch *watch, int timeout_ms);
+void watch_close(file_watch *watch);
+
+void follow_file(options *option);
+void tail_follow_file(options *option);
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef HASH_H
+#define HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Streaming XXH64 state (fast non-cryptographic 64-bit digest).
+typedef struct {
+    uint64_t total_len;
+    uint64_t v[4];
+    unsigned char mem[32];
+    size_t mem_size;
+    uint64_t seed;
+} xxh64_state;
+
+void xxh64_init(xxh64_state *state, uint64_t seed);
+void xxh64_update(xxh64_state *state, const void *data, size_t len);
+uint64_t xxh64_digest(const xxh64_state *state);
+uint64_t xxh64(const void *data, size_t len, uint64_t seed);
+
+// Streaming SHA-256 state.
+typedef struct {
+    uint32_t h[8];
+    uint64_t total_len;
+    unsigned char buf[64];
+    size_t buf_len;
+} sha256_state;
+
+void sha256_init(sha256_state *state);
+void sha256_update(sha256_state *state, const void *data, size_t len);
+void sha256_final(sha256_state *state, unsigned char out[32]);
+
+// CRC-32 (zlib / IEEE 802.3) and CRC-32C (Castagnoli), both start from crc = 0.
+void init_crc_tables(void);
+uint32_t crc32_update(uint32_t crc, const void *data, size_t len);
+uint32_t crc32c_update(uint32_t crc, const void *data, size_t len);
+
+// Digests selected with --hash, computed over exactly the bytes that were read.
+#define HASH_CRC32   (1u << 0)
+#define HASH_CRC32C  (1u << 1)
+#define HASH_XXH64   (1u << 2)
+#define HASH_SHA256  (1u << 3)
+
+typedef struct {
+    unsigned int mask;
+    uint32_t crc32;
+    uint32_t crc32c;
+    xxh64_state xxh;
+    sha256_state sha;
+} digest_set;
+
+int parse_hash_list(const char *list);
+void digest_set_init(digest_set *set, unsigned int mask);
+void digest_set_update(digest_set *set, const void *data, size_t len);
+void digest_set_format(digest_set *set, unsigned int algorithm, char *out, size_t out_size);
+const char *hash_name(unsigned int algorithm);
+
+#endif
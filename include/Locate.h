@@ -0,0 +1,21 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef LOCATE_H
+#define LOCATE_H
+
+#include "Args.h"
+
+#define LOCATE_BLOCK_SIZE 1024          // Needle block size, smaller needles are one block
+#define LOCATE_MIN_BLOCK 16             // Shorter needles give too many accidental hits
+#define LOCATE_HASH_PRIME 0x100000001B3ULL  // Multiplier of the polynomial rolling hash
+#define LOCATE_FILTER_SHIFT 16          // Hash bits of the prefilter bitmap
+#define LOCATE_FILTER_BITS (1 << LOCATE_FILTER_SHIFT)
+
+void print_locate(options *option);
+
+#endif
@@ -8,8 +8,10 @@
 #ifndef MAGIC_SIGNATURES_H
 #define MAGIC_SIGNATURES_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <stdio.h>
 
 typedef struct {
     const uint8_t *bytes;
@@ -24,4 +26,11 @@ typedef struct {
 extern const int Magic_Signatures_Count;
 extern const MagicSignature Magic_Signatures[];
 
+int count_found_magic(void);
+bool magic_found(int sig_id);
+void get_found_magic(unsigned char flags[256]);
+void set_found_magic(const unsigned char flags[256]);
+void reset_found_magic(void);
+void find_magic_bytes_in_stream_header(FILE *file);
+
 #endif
@@ -0,0 +1,22 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef PAGER_H
+#define PAGER_H
+
+#include <stdbool.h>
+
+#include "Args.h"
+
+#define PAGER_PREFETCH_SCREENS 2        // Screens below the viewport hinted to the kernel
+#define PAGER_ESC_TIMEOUT_MS 50         // Wait for the rest of an escape sequence
+#define PAGER_PROMPT_SIZE 256           // Input line of the offset and search prompts
+
+bool pager_available(const options *option);
+void run_pager(options *option);
+
+#endif
@@ -0,0 +1,26 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef PATCH_H
+#define PATCH_H
+
+#include "Args.h"
+
+#define PATCH_MAGIC "HXPATCH1"          // First 8 bytes of every patch
+#define PATCH_CHUNK_AVG 1024            // Average anchor chunk size used for matching
+#define PATCH_MAX_ANCHORS (1 << 22)     // Source anchors, larger sources get larger chunks
+#define PATCH_MIN_SEGMENT (1 << 20)     // Smallest part of the target matched by one worker
+
+// Patch operations (one tag byte each, followed by LEB128 varints).
+#define PATCH_OP_END    'E'             // End of the operation stream
+#define PATCH_OP_COPY   'C'             // zigzag delta of the source offset, length
+#define PATCH_OP_INSERT 'I'             // length, literal bytes
+
+void make_patch(options *option);
+void apply_patch(options *option);
+
+#endif
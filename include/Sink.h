@@ -0,0 +1,44 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef SINK_H
+#define SINK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "DisplayUtils.h"
+
+#define SINK_MAX_IOV 16                 // Buffers passed to one writev call
+
+typedef enum {
+    SINK_FD,        // write/writev on a file descriptor
+    SINK_FILE,      // fwrite on a stdio stream
+    SINK_PAGER      // Pipe into the pager, closed with pclose
+} sink_kind;
+
+// Destination of the rendered dump. stream is the stdio view of the same destination,
+// used for header and footer rows; it is flushed before raw writes go to fd.
+typedef struct {
+    sink_kind kind;
+    int fd;
+    FILE *stream;
+} output_sink;
+
+void sink_from_fd(output_sink *sink, int fd, FILE *stream);
+void sink_from_file(output_sink *sink, FILE *stream);
+void sink_stdout(output_sink *sink);
+void sink_open_pager(output_sink *sink);
+int sink_writev(output_sink *sink, text_buffer *const *bufs, size_t count);
+bool sink_reader_gone(int error);
+bool sink_reader_closed(output_sink *sink);
+int sink_exit_status(int error);
+int sink_flush(output_sink *sink);
+int sink_close(output_sink *sink);
+
+#endif
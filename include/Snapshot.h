@@ -0,0 +1,20 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "Args.h"
+
+#define SNAPSHOT_MAGIC "HXSNAP01"       // First 8 bytes of every snapshot
+#define SNAPSHOT_BLOCK_SIZE 65536       // Bytes covered by one leaf of the tree
+#define SNAPSHOT_MAX_LEVELS 64          // Binary tree over at most 2^63 leaves
+
+void write_snapshot(options *option);
+void print_since(options *option);
+
+#endif
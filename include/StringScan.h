@@ -0,0 +1,19 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef STRINGSCAN_H
+#define STRINGSCAN_H
+
+#include "Args.h"
+
+#define DEFAULT_STRINGS_MIN 4
+#define MAX_STRINGS_MIN 1024
+#define STRINGS_LINE_CAP 4096   // Longer strings are written in pieces of this size
+
+void print_strings(options *option);
+
+#endif
@@ -0,0 +1,22 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <stddef.h>
+
+#define MAX_WORKERS 64
+
+// Worker entry point. Every worker gets the shared context plus its own id,
+// so it can pick its slice of the work without extra bookkeeping.
+typedef void (*worker_fn)(void *ctx, int worker_id, int worker_count);
+
+int get_worker_count(void);
+void run_workers(worker_fn fn, void *ctx, int worker_count);
+
+#endif
@@ -37,6 +37,12 @@ extern const char *heatmap_colors[16];
 
 #define INDEX_MAP(value, min, max) (int) (((float)(value - min) / (float)(max - min)) * 15.0 + 0.5)
 
+// SSE2 is part of every x86-64 target, the vector kernels fall back to scalar code elsewhere.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define HXED_HAVE_SSE2 1
+#endif
+
 #ifdef _WIN32
     // Windows-specific definitions for popen and fileno
     #define popen _popen
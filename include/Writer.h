@@ -0,0 +1,30 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "DisplayUtils.h"
+#include "Sink.h"
+
+#define WRITER_BUFFER_SIZE (256 * 1024) // Rendered text handed to the writer thread at once
+#define WRITER_QUEUE_DEPTH 4            // Full buffers in flight before rendering blocks
+#define WRITER_PROBE_INTERVAL 64        // Submits between checks for a closed pipe reader
+
+typedef struct output_writer output_writer;
+
+output_writer *writer_open(output_sink *sink);
+text_buffer *writer_buffer(output_writer *writer);
+bool writer_submit(output_writer *writer);
+void writer_write(output_writer *writer, const char *data, size_t len);
+int writer_close(output_writer *writer);
+
+#endif
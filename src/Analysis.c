@@ -0,0 +1,841 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+/* Whole-range analysis without rendering a dump.
+ * How it works:
+ * - The read range is split into one slice per worker thread.
+ * - Every worker opens its own file handle and builds a private histogram.
+ * - The histograms are merged and all statistics are derived from the 256 bins.
+ * - The entropy map does the same per fixed block and draws one glyph per block (or group of blocks).
+ * - The segment report classifies blocks in one sequential pass and merges equal neighbours into ranges.
+ * - With --cache, whole CACHE_BLOCK_SIZE blocks come from the sidecar and only the
+ *   unaligned edges of the range are read.
+ */
+
+#include "Analysis.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Cache.h"
+#include "DisplayUtils.h"
+#include "File.h"
+#include "Threads.h"
+
+static float nlog2n_table[NLOG2N_TABLE_SIZE + 1];   // n * log2(n), index 0 is 0
+
+// Shared state for the histogram workers.
+typedef struct {
+    const char *filename;
+    size_t start;
+    size_t end;
+    byte_histogram partial[MAX_WORKERS];
+    digest_set *digests;   // Hashed sequentially by one extra worker, NULL = no --hash
+} histogram_job;
+
+// Counts byte values with four interleaved sub-histograms. Consecutive bytes land in
+// different tables, so runs of the same value don't serialize on one counter.
+void histogram_update(byte_histogram *hist, const unsigned char *data, size_t len) {
+    // 32-bit counters are flushed before they can overflow.
+    enum { FLUSH_SIZE = 1u << 30 };
+    uint32_t counts[4][256];
+
+    while (len > 0) {
+        size_t block = len < FLUSH_SIZE ? len : FLUSH_SIZE;
+        size_t i = 0;
+
+        memset(counts, 0, sizeof(counts));
+
+        for (; i + 8 <= block; i += 8) {
+            uint64_t word;
+            memcpy(&word, data + i, sizeof(word));
+
+            counts[0][(uint8_t)(word)]++;
+            counts[1][(uint8_t)(word >> 8)]++;
+            counts[2][(uint8_t)(word >> 16)]++;
+            counts[3][(uint8_t)(word >> 24)]++;
+            counts[0][(uint8_t)(word >> 32)]++;
+            counts[1][(uint8_t)(word >> 40)]++;
+            counts[2][(uint8_t)(word >> 48)]++;
+            counts[3][(uint8_t)(word >> 56)]++;
+        }
+
+        for (; i < block; i++) {
+            counts[0][data[i]]++;
+        }
+
+        for (int b = 0; b < 256; b++) {
+            hist->counts[b] += (uint64_t)counts[0][b] + counts[1][b] + counts[2][b] + counts[3][b];
+        }
+
+        hist->total += block;
+        data += block;
+        len -= block;
+    }
+}
+
+void histogram_merge(byte_histogram *dst, const byte_histogram *src) {
+    for (int b = 0; b < 256; b++) {
+        dst->counts[b] += src->counts[b];
+    }
+    dst->total += src->total;
+}
+
+// Fills the n*log2(n) table. Called once from main before any mode runs, so worker
+// threads only ever read it.
+void init_entropy_table(void) {
+    nlog2n_table[0] = 0.0f;
+    for (size_t n = 1; n <= NLOG2N_TABLE_SIZE; n++) {
+        nlog2n_table[n] = (float)((double)n * log2((double)n));
+    }
+}
+
+// Shannon entropy in bits per byte from symbol counts:
+//   H = log2(total) - sum(n * log2(n)) / total
+// so only one log per call is computed, every count is a table lookup.
+float entropy_from_counts(const uint64_t counts[256], uint64_t total) {
+    if (total == 0) return 0.0f;
+
+    double sum = 0.0;
+    for (int b = 0; b < 256; b++) {
+        uint64_t n = counts[b];
+        if (n <= NLOG2N_TABLE_SIZE) sum += nlog2n_table[n];
+        else sum += (double)n * log2((double)n);
+    }
+
+    double entropy = log2((double)total) - sum / (double)total;
+    return entropy > 0.0 ? (float)entropy : 0.0f;
+}
+
+// Shannon entropy in bits per byte, computed from the bins instead of the data.
+double histogram_entropy(const byte_histogram *hist) {
+    return entropy_from_counts(hist->counts, hist->total);
+}
+
+// Derives the footer byte classes (zero, printable, control, extended) from a histogram.
+void histogram_to_analysis(const byte_histogram *hist, dump_analysis *analysis) {
+    analysis->total_bytes += (size_t)hist->total;
+    analysis->zero_bytes += (size_t)hist->counts[0];
+
+    for (int b = 0x01; b <= 0x1F; b++) analysis->control += (size_t)hist->counts[b];
+    for (int b = 0x20; b <= 0x7E; b++) analysis->printable += (size_t)hist->counts[b];
+    analysis->control += (size_t)hist->counts[0x7F];
+    for (int b = 0x80; b <= 0xFF; b++) analysis->extended_ascii += (size_t)hist->counts[b];
+}
+
+// Worker: histogram of one contiguous slice of the range, read through a private handle.
+static void histogram_worker(void *ctx, int worker_id, int worker_count) {
+    histogram_job *job = (histogram_job *)ctx;
+    byte_histogram *hist = &job->partial[worker_id];
+    size_t span = job->end - job->start;
+
+    // Slices are aligned to the chunk size so every worker does full-size reads.
+    size_t chunks = (span + ANALYSIS_CHUNK_SIZE - 1) / ANALYSIS_CHUNK_SIZE;
+    size_t first = chunks * (size_t)worker_id / (size_t)worker_count;
+    size_t last = chunks * (size_t)(worker_id + 1) / (size_t)worker_count;
+
+    size_t pos = job->start + first * ANALYSIS_CHUNK_SIZE;
+    size_t stop = job->start + last * ANALYSIS_CHUNK_SIZE;
+    if (stop > job->end) stop = job->end;
+    if (pos >= stop) return;
+
+    FILE *file = fopen(job->filename, "rb");
+    unsigned char *chunk = malloc(ANALYSIS_CHUNK_SIZE);
+    if (!file || !chunk) {
+        perror("Stats worker failed");
+        exit(EXIT_FAILURE);
+    }
+
+    file_seek(file, pos);
+
+    while (pos < stop) {
+        size_t to_read = stop - pos < ANALYSIS_CHUNK_SIZE ? stop - pos : ANALYSIS_CHUNK_SIZE;
+        size_t got = fread(chunk, 1, to_read, file);
+        if (got == 0) break;
+
+        histogram_update(hist, chunk, got);
+        pos += got;
+    }
+
+    free(chunk);
+    fclose(file);
+}
+
+// Digests need the bytes in order, so they run in their own worker next to the
+// histogram slices instead of after them.
+static void stats_worker(void *ctx, int worker_id, int worker_count) {
+    histogram_job *job = (histogram_job *)ctx;
+
+    if (!job->digests) {
+        histogram_worker(ctx, worker_id, worker_count);
+        return;
+    }
+
+    if (worker_id < worker_count - 1) {
+        histogram_worker(ctx, worker_id, worker_count - 1);
+        return;
+    }
+
+    FILE *file = fopen(job->filename, "rb");
+    unsigned char *chunk = malloc(ANALYSIS_CHUNK_SIZE);
+    if (!file || !chunk) {
+        perror("Hash worker failed");
+        exit(EXIT_FAILURE);
+    }
+
+    range_reader reader;
+    range_reader_init(&reader, file, false, job->start, job->end);
+
+    size_t got;
+    while ((got = range_reader_read(&reader, chunk, ANALYSIS_CHUNK_SIZE)) > 0) {
+        digest_set_update(job->digests, chunk, got);
+    }
+
+    free(chunk);
+    fclose(file);
+}
+
+// Sequential histogram for stdin. Offset and limit are applied by discarding / stopping.
+static void histogram_stream(FILE *file, size_t start, size_t end, byte_histogram *hist, digest_set *digests) {
+    unsigned char *chunk = malloc(ANALYSIS_CHUNK_SIZE);
+    if (!chunk) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    range_reader reader;
+    range_reader_init(&reader, file, true, start, end);
+
+    size_t got;
+    while ((got = range_reader_read(&reader, chunk, ANALYSIS_CHUNK_SIZE)) > 0) {
+        histogram_update(hist, chunk, got);
+        if (digests->mask) digest_set_update(digests, chunk, got);
+    }
+
+    free(chunk);
+}
+
+// Prints the top n byte values by frequency, each with a heatmap colored bar.
+static void print_top_distribution(FILE *out, const options *option, const byte_histogram *hist, int top_n) {
+    int order[256];
+    for (int b = 0; b < 256; b++) order[b] = b;
+
+    // Partial selection sort, top_n is small.
+    for (int i = 0; i < top_n && i < 256; i++) {
+        int best = i;
+        for (int j = i + 1; j < 256; j++) {
+            if (hist->counts[order[j]] > hist->counts[order[best]]) best = j;
+        }
+        int tmp = order[i];
+        order[i] = order[best];
+        order[best] = tmp;
+    }
+
+    enum { BAR_WIDTH = 24 };
+    uint64_t top_count = hist->counts[order[0]];
+
+    for (int i = 0; i < top_n && i < 256; i++) {
+        int b = order[i];
+        if (hist->counts[b] == 0) break;
+
+        double pct = hist->total ? (double)hist->counts[b] * 100.0 / (double)hist->total : 0.0;
+        int bar_len = top_count ? (int)((hist->counts[b] * BAR_WIDTH + top_count - 1) / top_count) : 0;
+
+        char bar[BAR_WIDTH * 3 + 1] = {0};
+        size_t bar_pos = 0;
+        for (int j = 0; j < bar_len; j++) {
+            append_to_line(bar, sizeof(bar), &bar_pos, "█");
+        }
+
+        char disp = (b >= 32 && b < 127) ? (char)b : '.';
+        print_report_row(out, option, i == 0 ? "top" : "", "0x%02X '%c' %12llu (%5.1f%%) %s%s",
+                         b, disp, (unsigned long long)hist->counts[b], pct,
+                         option->color ? heatmap_colors[INDEX_MAP(pct, 0.0f, 100.0f)] : "",
+                         bar);
+    }
+}
+
+// Histogram of [start, end) read directly, used for the range edges next to cached blocks.
+static void histogram_range(const char *filename, size_t start, size_t end, byte_histogram *hist) {
+    if (start >= end) return;
+
+    FILE *file = fopen(filename, "rb");
+    unsigned char *chunk = malloc(CACHE_BLOCK_SIZE);
+    if (!file || !chunk) {
+        perror("Stats worker failed");
+        exit(EXIT_FAILURE);
+    }
+
+    range_reader reader;
+    range_reader_init(&reader, file, false, start, end);
+
+    size_t got;
+    while ((got = range_reader_read(&reader, chunk, CACHE_BLOCK_SIZE)) > 0) {
+        histogram_update(hist, chunk, got);
+    }
+
+    free(chunk);
+    fclose(file);
+}
+
+// Histogram of [start, end) from the sidecar cache: aligned blocks are looked up (and
+// revalidated if needed), the partial blocks at both ends are read directly.
+static void histogram_cached(block_cache *cache, const char *filename, size_t start, size_t end, byte_histogram *hist) {
+    if (end > cache->key.size) end = (size_t)cache->key.size;
+    if (start >= end) return;
+
+    size_t first = (start + CACHE_BLOCK_SIZE - 1) / CACHE_BLOCK_SIZE;
+    size_t last = end == cache->key.size ? cache->block_count : end / CACHE_BLOCK_SIZE;
+
+    if (first >= last) {
+        histogram_range(filename, start, end, hist);
+        return;
+    }
+
+    histogram_range(filename, start, first * CACHE_BLOCK_SIZE, hist);
+    if (last * CACHE_BLOCK_SIZE < end) histogram_range(filename, last * CACHE_BLOCK_SIZE, end, hist);
+
+    cache_prepare(cache, filename, first, last);
+    cache_histogram(cache, first, last, hist);
+}
+
+// --stats-only: footer statistics, entropy and byte distribution without rendering the dump.
+void print_stats_only(options *option) {
+    FILE *out = stdout;
+    byte_histogram hist = {0};
+    dump_analysis analysis = {0};
+    digest_set digests;
+    int workers = 1;
+
+    reset_display_utils_state();
+    digest_set_init(&digests, option->hash_mask);
+
+    size_t start = option->offset_read;
+    size_t end = get_read_end(option);
+
+    // Digests need every byte, so --hash bypasses the cache.
+    block_cache cache = {0};
+    bool cached = option->cache && !option->pipeline && !digests.mask && cache_open(&cache, option->filename);
+
+    if (option->pipeline) {
+        histogram_stream(stdin, start, end, &hist, &digests);
+    } else if (cached) {
+        if (!option->skip_header) cache_magic(&cache, option->filename);
+        histogram_cached(&cache, option->filename, start, end, &hist);
+        cache_save(&cache, option->filename);
+    } else {
+        FILE *file = open_input_file(option);
+        if (!option->skip_header) find_magic_bytes_in_stream_header(file);
+        fclose(file);
+
+        // Small ranges are not worth a thread per core.
+        size_t chunks = end > start ? (end - start + ANALYSIS_CHUNK_SIZE - 1) / ANALYSIS_CHUNK_SIZE : 0;
+        workers = get_worker_count();
+        if ((size_t)workers > chunks) workers = chunks > 0 ? (int)chunks : 1;
+        if (workers > MAX_WORKERS - 1) workers = MAX_WORKERS - 1;
+
+        histogram_job *job = calloc(1, sizeof(histogram_job));
+        if (!job) {
+            perror("Malloc failed");
+            exit(EXIT_FAILURE);
+        }
+
+        job->filename = option->filename;
+        job->start = start;
+        job->end = end;
+        job->digests = digests.mask ? &digests : NULL;
+
+        if (end > start) run_workers(stats_worker, job, job->digests ? workers + 1 : workers);
+
+        for (int i = 0; i < workers; i++) {
+            histogram_merge(&hist, &job->partial[i]);
+        }
+        free(job);
+    }
+
+    histogram_to_analysis(&hist, &analysis);
+    analysis.magic_count = count_found_magic();
+
+    double total = analysis.total_bytes ? (double)analysis.total_bytes : 1.0;
+    int row_width = calc_row_width(option, 8, _calc_visible_columns(option));
+
+    if (option->color) fprintf(out, "%s", HEADER_COLOR);
+    fprintf(out, "\nstats for %s:\n", option->pipeline ? "<pipe>" : option->filename);
+    if (option->color) fprintf(out, "%s", BORDER_COLOR);
+    for (int i = 0; i < row_width; i++) fputc('-', out);
+    if (option->color) fprintf(out, "%s", RESET);
+    fputc('\n', out);
+
+    print_report_row(out, option, "summary", "size %zu B ; zero %zu (%.1f%%) ; magic %d",
+                     analysis.total_bytes,
+                     analysis.zero_bytes, analysis.zero_bytes * 100.0 / total,
+                     analysis.magic_count);
+
+    print_report_row(out, option, "stats", "printable %zu (%.1f%%) ; control %zu (%.1f%%) ; extended %zu (%.1f%%)",
+                     analysis.printable, analysis.printable * 100.0 / total,
+                     analysis.control, analysis.control * 100.0 / total,
+                     analysis.extended_ascii, analysis.extended_ascii * 100.0 / total);
+
+    int distinct = 0;
+    for (int b = 0; b < 256; b++) {
+        if (hist.counts[b] != 0) distinct++;
+    }
+    print_report_row(out, option, "entropy", "%.4f bits/byte ; distinct values %d", histogram_entropy(&hist), distinct);
+
+    if (analysis.magic_count > 0) {
+        char magic_line[1024] = {0};
+        size_t magic_pos = 0;
+        append_magic_summary(magic_line, sizeof(magic_line), &magic_pos);
+        print_report_row(out, option, "magic", "%s", magic_line);
+    }
+
+    print_top_distribution(out, option, &hist, option->top_n);
+    if (digests.mask) print_digest_rows(out, option, &digests);
+
+    if (cached) {
+        print_report_row(out, option, "cache", "%s ; reused %zu ; computed %zu blocks of %d B",
+                         cache.key_match ? "hit" : "updated", cache.reused, cache.computed, CACHE_BLOCK_SIZE);
+        cache_close(&cache);
+    }
+
+    if (end != 0) {
+        print_report_row(out, option, "view", "offset %zu ; limit %zu ; workers %d", start, end, workers);
+    } else {
+        print_report_row(out, option, "view", "offset %zu ; limit eof ; workers %d", start, workers);
+    }
+
+    fputc('\n', out);
+}
+
+// Shared state for the entropy map workers, one result per block.
+typedef struct {
+    const char *filename;
+    size_t start;
+    size_t end;
+    size_t block;
+    size_t block_count;
+    float *entropy;
+} entropy_map_job;
+
+// Worker: entropy of a contiguous run of blocks, read in chunks through a private handle.
+static void entropy_map_worker(void *ctx, int worker_id, int worker_count) {
+    entropy_map_job *job = (entropy_map_job *)ctx;
+    size_t first = job->block_count * (size_t)worker_id / (size_t)worker_count;
+    size_t last = job->block_count * (size_t)(worker_id + 1) / (size_t)worker_count;
+    if (first >= last) return;
+
+    FILE *file = fopen(job->filename, "rb");
+    unsigned char *chunk = malloc(ANALYSIS_CHUNK_SIZE);
+    if (!file || !chunk) {
+        perror("Entropy map worker failed");
+        exit(EXIT_FAILURE);
+    }
+
+    file_seek(file, job->start + first * job->block);
+
+    for (size_t blk = first; blk < last; blk++) {
+        size_t pos = job->start + blk * job->block;
+        size_t stop = pos + job->block < job->end ? pos + job->block : job->end;
+        byte_histogram hist = {0};
+
+        while (pos < stop) {
+            size_t to_read = stop - pos < ANALYSIS_CHUNK_SIZE ? stop - pos : ANALYSIS_CHUNK_SIZE;
+            size_t got = fread(chunk, 1, to_read, file);
+            if (got == 0) break;
+
+            histogram_update(&hist, chunk, got);
+            pos += got;
+        }
+
+        job->entropy[blk] = histogram_entropy(&hist);
+    }
+
+    free(chunk);
+    fclose(file);
+}
+
+// Sequential entropy map for stdin, the block array grows with the stream.
+static float *entropy_map_stream(FILE *file, size_t start, size_t end, size_t block, size_t *block_count) {
+    unsigned char *chunk = malloc(ANALYSIS_CHUNK_SIZE);
+    size_t cap = 1024;
+    float *entropy = malloc(cap * sizeof(float));
+    if (!chunk || !entropy) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    byte_histogram hist = {0};
+    size_t count = 0;
+
+    range_reader reader;
+    range_reader_init(&reader, file, true, start, end);
+
+    size_t got;
+    while ((got = range_reader_read(&reader, chunk, ANALYSIS_CHUNK_SIZE)) > 0) {
+        size_t i = 0;
+        while (i < got) {
+            size_t take = block - (size_t)hist.total;
+            if (take > got - i) take = got - i;
+
+            histogram_update(&hist, chunk + i, take);
+            i += take;
+
+            if (hist.total == block) {
+                if (count == cap) {
+                    cap *= 2;
+                    float *tmp = realloc(entropy, cap * sizeof(float));
+                    if (!tmp) {
+                        perror("Malloc failed");
+                        exit(EXIT_FAILURE);
+                    }
+                    entropy = tmp;
+                }
+                entropy[count++] = histogram_entropy(&hist);
+                memset(&hist, 0, sizeof(hist));
+            }
+        }
+    }
+
+    if (hist.total > 0) {
+        if (count == cap) {
+            float *tmp = realloc(entropy, (cap + 1) * sizeof(float));
+            if (!tmp) {
+                perror("Malloc failed");
+                exit(EXIT_FAILURE);
+            }
+            entropy = tmp;
+        }
+        entropy[count++] = histogram_entropy(&hist);
+    }
+
+    free(chunk);
+    *block_count = count;
+    return entropy;
+}
+
+// --entropy-map: one glyph per block (or per group of blocks), MAP_COLUMNS cells per row,
+// so the layout of the whole range fits on one screen.
+void print_entropy_map(options *option) {
+    FILE *out = stdout;
+    size_t start = option->offset_read;
+    size_t end = get_read_end(option);
+    size_t block = option->map_block;
+    size_t block_count = 0;
+    float *entropy = NULL;
+
+    if (option->pipeline) {
+        if (block == 0) block = MAP_DEFAULT_BLOCK;
+        entropy = entropy_map_stream(stdin, start, end, block, &block_count);
+    } else {
+        size_t span = end > start ? end - start : 0;
+
+        // Auto block size: smallest power of two that fits the range on one screen.
+        // With --cache it starts at the cache block, so the map can be taken from the sidecar.
+        if (block == 0) {
+            block = option->cache ? CACHE_BLOCK_SIZE : 4096;
+            while (block * MAP_COLUMNS * MAP_MAX_ROWS < span) block *= 2;
+        }
+
+        block_count = (span + block - 1) / block;
+        entropy = calloc(block_count > 0 ? block_count : 1, sizeof(float));
+        if (!entropy) {
+            perror("Malloc failed");
+            exit(EXIT_FAILURE);
+        }
+
+        int workers = get_worker_count();
+        if ((size_t)workers > block_count) workers = block_count > 0 ? (int)block_count : 1;
+
+        // Block-aligned maps can be built from cached block counts without reading the file.
+        block_cache cache = {0};
+        bool aligned = block % CACHE_BLOCK_SIZE == 0 && start % CACHE_BLOCK_SIZE == 0;
+        bool cached = option->cache && aligned && cache_open(&cache, option->filename);
+        if (cached && end % CACHE_BLOCK_SIZE != 0 && end != cache.key.size) {
+            cache_close(&cache);
+            cached = false;
+            aligned = false;
+        }
+
+        if (option->cache && !aligned) {
+            fprintf(stderr, "Cache bypassed: offset, limit and block of the entropy map must be multiples of %d B\n",
+                    CACHE_BLOCK_SIZE);
+        }
+
+        if (cached) {
+            size_t per_block = block / CACHE_BLOCK_SIZE;
+            size_t first = start / CACHE_BLOCK_SIZE;
+            cache_prepare(&cache, option->filename, first, (end + CACHE_BLOCK_SIZE - 1) / CACHE_BLOCK_SIZE);
+
+            for (size_t blk = 0; blk < block_count; blk++) {
+                byte_histogram hist = {0};
+                size_t cache_end = first + (blk + 1) * per_block;
+                if (cache_end * CACHE_BLOCK_SIZE > end) cache_end = (end + CACHE_BLOCK_SIZE - 1) / CACHE_BLOCK_SIZE;
+
+                cache_histogram(&cache, first + blk * per_block, cache_end, &hist);
+                entropy[blk] = histogram_entropy(&hist);
+            }
+
+            cache_save(&cache, option->filename);
+            cache_close(&cache);
+        } else {
+            entropy_map_job job = {option->filename, start, end, block, block_count, entropy};
+            if (block_count > 0) run_workers(entropy_map_worker, &job, workers);
+        }
+    }
+
+    // Aggregate blocks into cells once the map would not fit on one screen.
+    size_t per_cell = (block_count + MAP_COLUMNS * MAP_MAX_ROWS - 1) / (MAP_COLUMNS * MAP_MAX_ROWS);
+    if (per_cell == 0) per_cell = 1;
+    size_t cell_bytes = per_cell * block;
+
+    size_t max_addr = start + block_count * block;
+    int addr_width = _hex_digits_size_t(max_addr);
+    if (addr_width < 8) addr_width = 8;
+    int row_width = addr_width + 3 + MAP_COLUMNS;
+
+    if (option->color) fprintf(out, "%s", HEADER_COLOR);
+    fprintf(out, "\nentropy map for %s (cell %zu B):\n", option->pipeline ? "<pipe>" : option->filename, cell_bytes);
+    if (option->color) fprintf(out, "%s", BORDER_COLOR);
+    for (int i = 0; i < row_width; i++) fputc('-', out);
+    if (option->color) fprintf(out, "%s", RESET);
+    fputc('\n', out);
+
+    float min_entropy = 8.0f;
+    float max_entropy = 0.0f;
+    double sum_entropy = 0.0;
+
+    char line[MAX_LINE_SIZE] = {0};
+    size_t line_pos = 0;
+    size_t cell_index = 0;
+
+    for (size_t blk = 0; blk < block_count; blk += per_cell) {
+        size_t blk_end = blk + per_cell < block_count ? blk + per_cell : block_count;
+        double cell_sum = 0.0;
+
+        for (size_t i = blk; i < blk_end; i++) {
+            if (entropy[i] < min_entropy) min_entropy = entropy[i];
+            if (entropy[i] > max_entropy) max_entropy = entropy[i];
+            cell_sum += entropy[i];
+        }
+        sum_entropy += cell_sum;
+
+        float cell = (float)(cell_sum / (double)(blk_end - blk));
+
+        if (cell_index % MAP_COLUMNS == 0) {
+            line_pos = 0;
+            if (option->color) {
+                append_to_line(line, sizeof(line), &line_pos, "%s%0*zX %s| ",
+                               ADDR_COLOR, addr_width, start + blk * block, BORDER_COLOR);
+            } else {
+                append_to_line(line, sizeof(line), &line_pos, "%0*zX | ", addr_width, start + blk * block);
+            }
+        }
+
+        if (option->color) {
+            append_to_line(line, sizeof(line), &line_pos, "%s%s", heatmap_colors[INDEX_MAP(cell, 0.0f, 8.0f)], entropy_bar_glyph(cell));
+        } else {
+            append_to_line(line, sizeof(line), &line_pos, "%s", entropy_bar_glyph(cell));
+        }
+
+        cell_index++;
+        if (cell_index % MAP_COLUMNS == 0 || blk_end == block_count) {
+            if (option->color) append_to_line(line, sizeof(line), &line_pos, "%s", RESET);
+            fputs(line, out);
+            fputc('\n', out);
+        }
+    }
+
+    if (option->color) fprintf(out, "%s", BORDER_COLOR);
+    for (int i = 0; i < row_width; i++) fputc('-', out);
+    if (option->color) fprintf(out, "%s", RESET);
+    fputc('\n', out);
+
+    if (block_count == 0) min_entropy = 0.0f;
+
+    print_report_row(out, option, "legend", "%s < 2  %s < 4  %s < 6  %s >= 6 bits/byte",
+                     entropy_bar_glyph(0.0f), entropy_bar_glyph(2.0f), entropy_bar_glyph(4.0f), entropy_bar_glyph(6.0f));
+    print_report_row(out, option, "entropy", "min %.2f ; max %.2f ; mean %.2f",
+                     min_entropy, max_entropy, block_count ? sum_entropy / (double)block_count : 0.0);
+    print_report_row(out, option, "view", "block %zu B ; blocks %zu ; blocks/cell %zu ; offset %zu",
+                     block, block_count, per_cell, start);
+    fputc('\n', out);
+
+    free(entropy);
+}
+
+// Region classes of the segment report, ordered from most to least structured.
+typedef enum {
+    SEG_ZERO,
+    SEG_FILL,
+    SEG_TEXT,
+    SEG_DATA,
+    SEG_CODE,
+    SEG_COMPRESSED,
+    SEG_ENCRYPTED,
+    SEG_CLASS_COUNT
+} segment_class;
+
+static const char *segment_names[SEG_CLASS_COUNT] = {
+    "zero", "fill", "text", "data", "code", "compressed", "encrypted"
+};
+
+// Classifies one block from its histogram: zero / printable ratios first, then entropy.
+// Random data of n bytes reaches only about 8 - 255 / (2 n ln 2) bits, so the
+// encrypted threshold is relative to that expected maximum, not to 8.0. Small blocks
+// (short files, the tail of a range) never go below the compressed band.
+static segment_class classify_block(const byte_histogram *hist, float entropy) {
+    double total = (double)hist->total;
+    uint64_t printable = hist->counts['\t'] + hist->counts['\n'] + hist->counts['\r'];
+    uint64_t top = 0;
+
+    for (int b = 0x20; b <= 0x7E; b++) printable += hist->counts[b];
+    for (int b = 0; b < 256; b++) {
+        if (hist->counts[b] > top) top = hist->counts[b];
+    }
+
+    double random_entropy = fmax(8.0 - 255.0 / (2.0 * total * 0.6931471805599453), 7.2);
+
+    if ((double)hist->counts[0] >= total * 0.99) return SEG_ZERO;
+    if ((double)top >= total * 0.99) return SEG_FILL;
+    if ((double)printable >= total * 0.85) return SEG_TEXT;
+    if (entropy >= random_entropy - 0.05) return SEG_ENCRYPTED;
+    if (entropy >= 7.2f) return SEG_COMPRESSED;
+    if (entropy >= 5.0f) return SEG_CODE;
+    return SEG_DATA;
+}
+
+// Current merged range of equally classified blocks.
+typedef struct {
+    size_t start;
+    size_t length;
+    size_t blocks;
+    double entropy_sum;
+    segment_class cls;
+} segment_range;
+
+static void print_segment_row(FILE *out, const options *option, const segment_range *range, int addr_width) {
+    float mean = (float)(range->entropy_sum / (double)range->blocks);
+
+    if (option->color) {
+        fprintf(out, "%s%0*zX %s| %s%12zu %s| %s%-10s %s| %s%.2f%s\n",
+                ADDR_COLOR, addr_width, range->start, BORDER_COLOR,
+                ANALYSIS_TEXT_COLOR, range->length, BORDER_COLOR,
+                heatmap_colors[INDEX_MAP(mean, 0.0f, 8.0f)], segment_names[range->cls], BORDER_COLOR,
+                ANALYSIS_TEXT_COLOR, mean, RESET);
+    } else {
+        fprintf(out, "%0*zX | %12zu | %-10s | %.2f\n",
+                addr_width, range->start, range->length, segment_names[range->cls], mean);
+    }
+}
+
+// --segments: one streaming pass over the range (file or stdin) with constant memory.
+// Every block is classified, adjacent blocks of the same class are merged into one row.
+void print_segments(options *option) {
+    FILE *out = stdout;
+    FILE *file = open_input_file(option);
+    size_t start = option->offset_read;
+    size_t end = get_read_end(option);
+    size_t block = option->segment_block;
+    size_t class_bytes[SEG_CLASS_COUNT] = {0};
+    size_t range_count = 0;
+
+    unsigned char *chunk = malloc(ANALYSIS_CHUNK_SIZE);
+    if (!chunk) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    int addr_width = _hex_digits_size_t(end);
+    if (addr_width < 8) addr_width = 8;
+    int row_width = addr_width + 3 + 12 + 3 + 10 + 3 + 7;
+
+    if (option->color) fprintf(out, "%s", HEADER_COLOR);
+    fprintf(out, "\nsegments for %s (block %zu B):\n", option->pipeline ? "<pipe>" : option->filename, block);
+    fprintf(out, "%-*s | %12s | %-10s | %s\n", addr_width, "offset", "length", "class", "entropy");
+    if (option->color) fprintf(out, "%s", BORDER_COLOR);
+    for (int i = 0; i < row_width; i++) fputc('-', out);
+    if (option->color) fprintf(out, "%s", RESET);
+    fputc('\n', out);
+
+    range_reader reader;
+    range_reader_init(&reader, file, option->pipeline, start, end);
+
+    byte_histogram hist = {0};
+    size_t block_start = start;
+    segment_range range = {0};
+    bool have_range = false;
+
+    while (1) {
+        size_t got = range_reader_read(&reader, chunk, ANALYSIS_CHUNK_SIZE);
+        size_t i = 0;
+
+        while (i < got || (got == 0 && hist.total > 0)) {
+            if (got > 0) {
+                size_t take = block - (size_t)hist.total;
+                if (take > got - i) take = got - i;
+                histogram_update(&hist, chunk + i, take);
+                i += take;
+                if (hist.total < block) continue;
+            }
+
+            // A full block, or the short tail at end of input.
+            float entropy = histogram_entropy(&hist);
+            segment_class cls = classify_block(&hist, entropy);
+
+            if (have_range && range.cls == cls) {
+                range.length += (size_t)hist.total;
+                range.blocks++;
+                range.entropy_sum += entropy;
+            } else {
+                if (have_range) {
+                    print_segment_row(out, option, &range, addr_width);
+                    range_count++;
+                }
+                range.start = block_start;
+                range.length = (size_t)hist.total;
+                range.blocks = 1;
+                range.entropy_sum = entropy;
+                range.cls = cls;
+                have_range = true;
+            }
+
+            class_bytes[cls] += (size_t)hist.total;
+            block_start += (size_t)hist.total;
+            memset(&hist, 0, sizeof(hist));
+        }
+
+        if (got == 0) break;
+    }
+
+    if (have_range) {
+        print_segment_row(out, option, &range, addr_width);
+        range_count++;
+    }
+
+    if (option->color) fprintf(out, "%s", BORDER_COLOR);
+    for (int i = 0; i < row_width; i++) fputc('-', out);
+    if (option->color) fprintf(out, "%s", RESET);
+    fputc('\n', out);
+
+    char classes[MAX_LINE_SIZE] = {0};
+    size_t classes_pos = 0;
+    for (int c = 0; c < SEG_CLASS_COUNT; c++) {
+        if (class_bytes[c] == 0) continue;
+        if (classes_pos > 0) append_to_line(classes, sizeof(classes), &classes_pos, " ; ");
+        append_to_line(classes, sizeof(classes), &classes_pos, "%s %zu B", segment_names[c], class_bytes[c]);
+    }
+
+    print_report_row(out, option, "classes", "%s", classes_pos > 0 ? classes : "none");
+    print_report_row(out, option, "view", "block %zu B ; ranges %zu ; offset %zu", block, range_count, start);
+    fputc('\n', out);
+
+    free(chunk);
+    if (!option->pipeline) fclose(file);
+}
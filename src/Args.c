@@ -6,6 +6,7 @@
  */
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <ctype.h>
 #include <stdlib.h>
 #include <string.h>
@@ -13,6 +14,11 @@
 #include <errno.h>
 #include "Args.h"
 #include "Config.h"
+#include "Analysis.h"
+#include "Dedup.h"
+#include "Hash.h"
+#include "StringScan.h"
+#include "Threads.h"
 #include "hxed_config.h"
 
 // issatty and fileno for Windows compatibility
@@ -52,6 +58,68 @@ size_t get_suffix(const char *endchar) {
     }
 }
 
+// True if the argument looks like a number, used for flags with an optional value.
+static bool is_numeric_argument(const char *value) {
+    return value != NULL && isdigit((unsigned char)value[0]);
+}
+
+// Parses one number of --range: decimal or 0x hex, with optional k/M/G suffix.
+static bool parse_range_number(const char *value, char **endptr, size_t *out) {
+    int base = value[0] == '0' && (value[1] == 'x' || value[1] == 'X') ? 16 : 10;
+    errno = 0;
+    unsigned long long val = strtoull(value, endptr, base);
+    if (*endptr == value || errno == ERANGE || value[0] == '-') return false;
+
+    size_t suffix = 1;
+    if (**endptr != '\0' && strchr("kKMG", **endptr)) {
+        suffix = get_suffix(*endptr);
+        (*endptr)++;
+    }
+    if (val > SIZE_MAX / suffix) return false;
+
+    *out = (size_t)val * suffix;
+    return true;
+}
+
+// Parses off:len of --range and appends it to the option ranges, exits on error.
+static void add_range_argument(const char *value, options *option) {
+    read_range range;
+    char *endptr;
+
+    if (!parse_range_number(value, &endptr, &range.offset) || *endptr != ':' ||
+        !parse_range_number(endptr + 1, &endptr, &range.length) || *endptr != '\0' || range.length == 0) {
+        fprintf(stderr, "Error: range must be off:len with len > 0 (e.g. 0x100:64, 1M:4K)\n");
+        exit(EXIT_FAILURE);
+    }
+
+    read_range *ranges = realloc(option->ranges, (option->range_count + 1) * sizeof(read_range));
+    if (!ranges) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    ranges[option->range_count++] = range;
+    option->ranges = ranges;
+}
+
+// Parses a positive size with optional k/M/G suffix for the given flag, exits on error.
+static size_t parse_size_value(const char *flag, const char *value) {
+    errno = 0;
+    char *endptr;
+    long long val = strtoll(value, &endptr, 10);
+
+    if (endptr == value) {
+        fprintf(stderr, "Error: %s requires a numeric value\n", flag);
+        exit(EXIT_FAILURE);
+    }
+    size_t suffix = get_suffix(endptr);
+    if (errno == ERANGE || val <= 0 || (unsigned long long)val > SIZE_MAX / suffix) {
+        fprintf(stderr, "Error: %s out of range\n", flag);
+        exit(EXIT_FAILURE);
+    }
+
+    return (size_t)val * suffix;
+}
+
 static void fail_search_parse(const char *value) {
     fprintf(stderr, "Error: invalid search value <%s>\n", value);
     exit(EXIT_FAILURE);
@@ -208,14 +276,39 @@ options *get_options(int argc, char *argv[]) {
     option->entropie = false;
     option->skip_header = false;
     option->skip_zero = false;
+    option->squeeze = false;
     option->reverse_mode = false;
     option->offset_read = 0;
     option->limit_read = 0;
     option->read_size = 0;
+    option->tail_size = 0;
     option->search = NULL;
     option->search_len = 0;
     option->pager = false;
     option->raw = false;
+    option->stats_only = false;
+    option->top_n = DEFAULT_TOP_N;
+    option->entropy_map = false;
+    option->map_block = 0;
+    option->segments = false;
+    option->segment_block = SEGMENT_DEFAULT_BLOCK;
+    option->strings = false;
+    option->strings_min = DEFAULT_STRINGS_MIN;
+    option->dedup_report = false;
+    option->dedup_avg = DEDUP_DEFAULT_AVG;
+    option->hash_mask = 0;
+    option->diff_file = NULL;
+    option->make_patch = NULL;
+    option->apply_patch = NULL;
+    option->follow = false;
+    option->tail_follow = false;
+    option->cache = false;
+    option->snapshot_out = NULL;
+    option->since_snapshot = NULL;
+    option->locate_needle = NULL;
+    option->jobs = 1;
+    option->ranges = NULL;
+    option->range_count = 0;
 
     // Apply configuration file settings (before CLI parsing)
     set_config(option);
@@ -244,11 +337,15 @@ options *get_options(int argc, char *argv[]) {
         "  -e,  --entropy                            Toggle entropy graph per line (default: off)\n"
         "  -th, --toggle-header                      Toggle header, footer and magic byte detection (default: on)\n"
         "  -sz, --skip-zero                          Toggle skip-zero lines (default: off)\n"
+        "  -sq, --squeeze                            Toggle collapsing repeated lines into '*' (default: off)\n"
         "  -re, --reverse                            Custom input to ascii output\n"
         "                                            (must use with -m to specify input mode, default: hex)\n"        
         "\n"
         "Read Range:\n"
         "  -o,  --offset          <num>              Start reading at this byte offset (default: 0)\n"
+        "                                            (negative: that many bytes before the end)\n"
+        "       --tail            <num>              Dump the last num bytes (same as -o -num)\n"
+        "       --range           <off:len>          Dump len bytes at off, repeatable (one read per nearby group)\n"
         "  -l,  --limit           <num|hex>          Stop at specific byte (default: read to EOF)\n"
         "  -r,  --read-size       <num>              Stop after this many bytes (default: read to EOF)\n"
         "\n"
@@ -261,6 +358,29 @@ options *get_options(int argc, char *argv[]) {
         "Output:\n"
         "  -p,  --pager                              Toggle pager output (default: off)\n"
         "  -ro, --raw                                Raw output to console | file (pipe)\n"
+        "       --jobs            <num>              Format the dump on num threads (default: 1, 0 = all cores)\n"
+        "\n"
+        "Analysis:\n"
+        "       --stats-only                         Print byte statistics, entropy and distribution only\n"
+        "       --top             <num>              Entries listed in distributions and reports (default: 10)\n"
+        "       --entropy-map     [block]            Print a block entropy map of the range (default block: auto)\n"
+        "       --segments        [block]            Classify regions (zero, text, code, compressed, ...) (default: 4096)\n"
+        "       --strings         [min]              Extract ASCII and UTF-16LE strings (default min: 4)\n"
+        "       --dedup-report    [avg]              Report duplicate content-defined chunks (default avg: 8192)\n"
+        "       --hash            <list>             Digests of the read range: crc32,crc32c,xxh64,sha256\n"
+        "       --cache                              Keep block summaries in <file>.hxcache for later runs\n"
+        "\n"
+        "Compare:\n"
+        "       --diff            <a> <b>            Insert / delete / modify regions of two files\n"
+        "       --make-patch      <a> <b>            Write a binary delta from a to b to stdout\n"
+        "       --apply-patch     <patch> <a>        Apply a delta to a, write the result to stdout\n"
+        "       --snapshot        <out>              Write a Merkle tree of 64 KB block hashes to out\n"
+        "       --since           <snap>             Print only the lines of blocks changed since snap\n"
+        "       --locate          <needle> <hay>     Offsets of the needle's 1 KB blocks inside hay\n"
+        "\n"
+        "Live:\n"
+        "       --follow                             Watch the file, print only lines that change\n"
+        "       --tail-follow                        Print bytes appended to the file (from EOF or -o)\n"
         "\n"
         "Info:\n"
         "       --show-config                        Show current config and exit\n"
@@ -273,14 +393,34 @@ options *get_options(int argc, char *argv[]) {
         "  hxed -c file | less -R             # toggle colors off\n"
         "  echo 'Hello World' | hxed          # pipeline to hxed\n"
         "  hxed -w 0 -ro test > o.txt         # raw output without newlines into a file\n"
+        "  hxed --jobs 0 disk.img > dump.txt  # format a large dump on all cores\n"
         "  hxed -s data.bin                   # with string highlighting\n"
+        "  hxed -sq flash.img                 # collapse erased / padding runs into *\n"
         "  hxed -se a:'Hello file'.bin        # ascii search\n"
         "  hxed -se x:48656c6c6f file.bin     # hex search\n"
         "  hxed -se b:01001000,01101001 file  # binary byte search\n"
         "  hxed -se d:72,101,108,108,111 file # decimal byte search\n"
+        "  hxed --stats-only --top 5 disk.img # statistics without dump\n"
+        "  hxed --entropy-map 4K firmware.bin # entropy overview, 4 KB blocks\n"
+        "  cat blob | hxed --segments         # region classification of a stream\n"
+        "  hxed --strings 8 -o 1M app.bin     # strings of at least 8 chars after 1 MB\n"
+        "  hxed --dedup-report --top 20 vm.img # 20 largest duplicate chunk groups\n"
+        "  hxed --stats-only --hash sha256 iso # statistics and SHA-256 of the file\n"
+        "  hxed --stats-only --cache disk.img # repeated runs only read changed blocks\n"
+        "  hxed --diff fw_v1.bin fw_v2.bin    # changed lines of two firmware builds\n"
+        "  hxed --make-patch v1 v2 > d.hxpatch # delta from v1 to v2\n"
+        "  hxed --apply-patch d.hxpatch v1 > v2 # rebuild v2 from v1\n"
+        "  hxed --snapshot vm.hxsnap vm.img   # remember the state of an image\n"
+        "  hxed --since vm.hxsnap vm.img      # lines changed since then\n"
+        "  hxed --locate lib.so fw.bin        # where the blocks of lib.so appear in fw.bin\n"
+        "  hxed --follow -o 4K -r 256 dev.log # live view of 256 bytes at 4 KB\n"
+        "  hxed --tail-follow capture.pcap    # like tail -f for binary data\n"
+        "  hxed --tail 22 archive.zip         # end of central directory of a ZIP\n"
+        "  curl -s URL | hxed -o -1K          # last KB of a stream\n"
+        "  hxed --range 0:64 --range 0x3C0:32 f # two regions, one process\n"
         "\n"
         "Notes:\n"
-        "  * Offsets and limits must be positive integers.\n"
+        "  * Limits must be positive integers, a negative offset counts from the end.\n"
         "  * Magic byte detection is inactive if offset is set\n"
         "  * --offset and --limit cannot be combined in a way that limit < offset.\n"
         "  * Only reading from file OR stdin (pipe) is supported.\n"
@@ -467,6 +607,11 @@ options *get_options(int argc, char *argv[]) {
             option->skip_zero = !option->skip_zero;
         }
 
+        else if (strcmp(argv[x], "-sq") == 0 || (strcmp(argv[x], "--squeeze") == 0)) {
+            // Squeeze flag toggle.
+            option->squeeze = !option->squeeze;
+        }
+
         else if (strcmp(argv[x], "-re") == 0 || (strcmp(argv[x], "--reverse") == 0)) {
             // Reverse flag toggle.
             option->reverse_mode = !option->reverse_mode;
@@ -505,13 +650,19 @@ options *get_options(int argc, char *argv[]) {
                     exit(EXIT_FAILURE);
                 }
 
-                // Check for positiv value
-                if (val <= 0) {
-                    fprintf(stderr, "Error: offset must be positive\n");
+                if (val == 0) {
+                    fprintf(stderr, "Error: offset must not be 0\n");
                     exit(EXIT_FAILURE);
                 }
-                // Set offset
-                option->offset_read = (size_t)val;
+
+                // Negative offsets count from the end, resolved once the size is known.
+                if (val < 0) {
+                    option->tail_size = (size_t)-val;
+                    option->offset_read = 0;
+                } else {
+                    option->offset_read = (size_t)val;
+                    option->tail_size = 0;
+                }
                 x++; // Skip the argument value.
             }
             
@@ -625,6 +776,37 @@ options *get_options(int argc, char *argv[]) {
             
         }
 
+        else if (strcmp(argv[x], "--tail") == 0) {
+            // Tail Flag: the last num bytes, like a negative offset.
+            if (x + 1 >= argc) {
+                fprintf(stderr, "Error: tail requires an argument\n");
+                printf("%s", help_short);
+                exit(EXIT_FAILURE);
+            }
+            else {
+                errno = 0;
+                char *endptr;
+                long val = strtol(argv[x + 1], &endptr, 10);
+
+                size_t suffix = get_suffix(endptr);
+
+                if (endptr == argv[x + 1]) {
+                    fprintf(stderr, "Error: tail requires a numeric value\n");
+                    printf("%s", help_short);
+                    exit(EXIT_FAILURE);
+                }
+
+                if (errno == ERANGE || val <= 0 || (unsigned long)val > SIZE_MAX / suffix) {
+                    fprintf(stderr, "Error: tail must be a positive number of bytes\n");
+                    exit(EXIT_FAILURE);
+                }
+
+                option->tail_size = (size_t)val * suffix;
+                option->offset_read = 0;
+                x++; // Skip the argument value.
+            }
+        }
+
         else if (strcmp(argv[x], "-se") == 0 || (strcmp(argv[x], "--search") == 0)){
             // Search quarry argument.
             if (x + 1 >= argc) {
@@ -648,6 +830,212 @@ options *get_options(int argc, char *argv[]) {
             option->raw = true;
         }
 
+        else if (strcmp(argv[x], "--stats-only") == 0) {
+            // Stats-only flag.
+            option->stats_only = true;
+        }
+
+        else if (strcmp(argv[x], "--entropy-map") == 0) {
+            // Entropy map with optional block size.
+            option->entropy_map = true;
+            if (x + 1 < argc && is_numeric_argument(argv[x + 1])) {
+                option->map_block = parse_size_value("entropy-map block", argv[x + 1]);
+                if (option->map_block < 64 || option->map_block > (size_t)1 << 30) {
+                    fprintf(stderr, "Error: entropy-map block out of range [64 - 1G]\n");
+                    exit(EXIT_FAILURE);
+                }
+                x++;
+            }
+        }
+
+        else if (strcmp(argv[x], "--segments") == 0) {
+            // Segmentation report with optional block size.
+            option->segments = true;
+            if (x + 1 < argc && is_numeric_argument(argv[x + 1])) {
+                option->segment_block = parse_size_value("segments block", argv[x + 1]);
+                if (option->segment_block < 64 || option->segment_block > (size_t)1 << 30) {
+                    fprintf(stderr, "Error: segments block out of range [64 - 1G]\n");
+                    exit(EXIT_FAILURE);
+                }
+                x++;
+            }
+        }
+
+        else if (strcmp(argv[x], "--strings") == 0) {
+            // Strings extraction with optional minimum length.
+            option->strings = true;
+            if (x + 1 < argc && is_numeric_argument(argv[x + 1])) {
+                option->strings_min = parse_size_value("strings min", argv[x + 1]);
+                if (option->strings_min > MAX_STRINGS_MIN) {
+                    fprintf(stderr, "Error: strings min out of range [1 - %d]\n", MAX_STRINGS_MIN);
+                    exit(EXIT_FAILURE);
+                }
+                x++;
+            }
+        }
+
+        else if (strcmp(argv[x], "--dedup-report") == 0) {
+            // Dedup report with optional average chunk size.
+            option->dedup_report = true;
+            if (x + 1 < argc && is_numeric_argument(argv[x + 1])) {
+                option->dedup_avg = parse_size_value("dedup-report avg", argv[x + 1]);
+                if (option->dedup_avg < 256 || option->dedup_avg > 262144) {
+                    fprintf(stderr, "Error: dedup-report avg out of range [256 - 262144]\n");
+                    exit(EXIT_FAILURE);
+                }
+                x++;
+            }
+        }
+
+        else if (strcmp(argv[x], "--hash") == 0) {
+            // Digest list argument parsing.
+            if (x + 1 >= argc) {
+                fprintf(stderr, "Error: hash requires an argument\n");
+                exit(EXIT_FAILURE);
+            }
+
+            int mask = parse_hash_list(argv[x + 1]);
+            if (mask < 0) {
+                fprintf(stderr, "Error: unknown hash list '%s' (crc32, crc32c, xxh64, sha256)\n", argv[x + 1]);
+                exit(EXIT_FAILURE);
+            }
+            option->hash_mask |= (unsigned int)mask;
+            x++;
+        }
+
+        else if (strcmp(argv[x], "--diff") == 0) {
+            // Diff takes both files, the first one becomes the regular input.
+            if (x + 2 >= argc) {
+                fprintf(stderr, "Error: diff requires two files\n");
+                printf("%s", help_short);
+                exit(EXIT_FAILURE);
+            }
+            option->filename = argv[x + 1];
+            option->diff_file = argv[x + 2];
+            x += 2;
+        }
+
+        else if (strcmp(argv[x], "--make-patch") == 0 || strcmp(argv[x], "--apply-patch") == 0) {
+            // Patch modes take two files, the source becomes the regular input.
+            bool make = strcmp(argv[x], "--make-patch") == 0;
+            if (x + 2 >= argc) {
+                fprintf(stderr, "Error: %s requires two files\n", argv[x]);
+                printf("%s", help_short);
+                exit(EXIT_FAILURE);
+            }
+
+            if (make) {
+                option->filename = argv[x + 1];
+                option->make_patch = argv[x + 2];
+            } else {
+                option->apply_patch = argv[x + 1];
+                option->filename = argv[x + 2];
+            }
+            x += 2;
+        }
+
+        else if (strcmp(argv[x], "--locate") == 0) {
+            // Locate takes the needle and the haystack, the haystack becomes the regular input.
+            if (x + 2 >= argc) {
+                fprintf(stderr, "Error: locate requires two files\n");
+                printf("%s", help_short);
+                exit(EXIT_FAILURE);
+            }
+            option->locate_needle = argv[x + 1];
+            option->filename = argv[x + 2];
+            x += 2;
+        }
+
+        else if (strcmp(argv[x], "--snapshot") == 0 || strcmp(argv[x], "--since") == 0) {
+            // Snapshot path argument parsing, the file is given as usual.
+            if (x + 1 >= argc) {
+                fprintf(stderr, "Error: %s requires a snapshot path\n", argv[x]);
+                exit(EXIT_FAILURE);
+            }
+
+            if (strcmp(argv[x], "--snapshot") == 0) option->snapshot_out = argv[x + 1];
+            else option->since_snapshot = argv[x + 1];
+            x++;
+        }
+
+        else if (strcmp(argv[x], "--follow") == 0) {
+            // Live view flag.
+            option->follow = true;
+        }
+
+        else if (strcmp(argv[x], "--tail-follow") == 0) {
+            // Append-only live view flag.
+            option->tail_follow = true;
+        }
+
+        else if (strcmp(argv[x], "--cache") == 0) {
+            // Sidecar cache flag.
+            option->cache = true;
+        }
+
+        else if (strcmp(argv[x], "--range") == 0) {
+            // Repeatable region argument parsing.
+            if (x + 1 >= argc) {
+                fprintf(stderr, "Error: range requires an argument\n");
+                printf("%s", help_short);
+                exit(EXIT_FAILURE);
+            }
+            add_range_argument(argv[x + 1], option);
+            x++;
+        }
+
+        else if (strcmp(argv[x], "--jobs") == 0) {
+            // Render thread count argument parsing.
+            if (x + 1 >= argc) {
+                fprintf(stderr, "Error: jobs requires an argument\n");
+                printf("%s", help_short);
+                exit(EXIT_FAILURE);
+            }
+
+            errno = 0;
+            char *endptr;
+            long val = strtol(argv[x + 1], &endptr, 10);
+
+            if (endptr == argv[x + 1]) {
+                fprintf(stderr, "Error: jobs requires a numeric value\n");
+                printf("%s", help_short);
+                exit(EXIT_FAILURE);
+            }
+            if (errno == ERANGE || val < 0 || val > MAX_WORKERS) {
+                fprintf(stderr, "Error: jobs out of range [0 - %d]\n", MAX_WORKERS);
+                exit(EXIT_FAILURE);
+            }
+
+            option->jobs = val == 0 ? get_worker_count() : (int)val;
+            x++;
+        }
+
+        else if (strcmp(argv[x], "--top") == 0) {
+            // Distribution size argument parsing.
+            if (x + 1 >= argc) {
+                fprintf(stderr, "Error: top requires an argument\n");
+                printf("%s", help_short);
+                exit(EXIT_FAILURE);
+            }
+
+            errno = 0;
+            char *endptr;
+            long val = strtol(argv[x + 1], &endptr, 10);
+
+            if (endptr == argv[x + 1]) {
+                fprintf(stderr, "Error: top requires a numeric value\n");
+                printf("%s", help_short);
+                exit(EXIT_FAILURE);
+            }
+            if (errno == ERANGE || val < 1 || val > 256) {
+                fprintf(stderr, "Error: top out of range [1 - 256]\n");
+                exit(EXIT_FAILURE);
+            }
+
+            option->top_n = (int)val;
+            x++;
+        }
+
         else if (strcmp(argv[x], "-p") == 0 || (strcmp(argv[x], "--pager") == 0)) {
             // Pager flag toggle.
             option->pager = !option->pager;
@@ -698,6 +1086,60 @@ options *get_options(int argc, char *argv[]) {
         exit(EXIT_FAILURE);
     }
     
+    if ((option->stats_only || option->entropy_map || option->segments || option->strings || option->dedup_report) && option->reverse_mode) {
+        fprintf(stderr, "Error: analysis modes cannot be combined with reverse mode\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (option->cache && option->pipeline) {
+        fprintf(stderr, "Error: cache needs a file, streams cannot be cached\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (option->locate_needle && (option->pipeline || option->reverse_mode)) {
+        fprintf(stderr, "Error: locate needs two files and cannot be combined with reverse mode\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if ((option->snapshot_out || option->since_snapshot) && (option->pipeline || option->reverse_mode || option->buff_size == 0)) {
+        fprintf(stderr, "Error: snapshots need a file and cannot be combined with reverse mode or width 0\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if ((option->follow || option->tail_follow) && (option->pipeline || option->reverse_mode || option->buff_size == 0)) {
+        fprintf(stderr, "Error: follow needs a file and cannot be combined with reverse mode or width 0\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (option->range_count > 0 && (option->offset_read || option->limit_read || option->read_size || option->tail_size)) {
+        fprintf(stderr, "Error: range cannot be combined with -o, -l, -r or --tail\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (option->range_count > 0 && (option->pipeline || option->reverse_mode || option->search_len || option->diff_file ||
+                                    option->make_patch || option->apply_patch || option->follow || option->tail_follow ||
+                                    option->snapshot_out || option->since_snapshot || option->locate_needle || option->stats_only ||
+                                    option->entropy_map || option->segments || option->strings || option->dedup_report)) {
+        fprintf(stderr, "Error: range needs a file and only applies to the dump, without search or reverse mode\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Files resolve the tail against their size (check_file), stdin keeps it in a ring in the dump.
+    if (option->tail_size != 0 && (option->reverse_mode || option->diff_file || option->make_patch || option->apply_patch || option->follow)) {
+        fprintf(stderr, "Error: tail cannot be combined with reverse, diff, patch or follow mode\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (option->tail_size != 0 && option->pipeline && (option->stats_only || option->entropy_map || option->segments || option->strings || option->dedup_report)) {
+        fprintf(stderr, "Error: tail on stdin is only supported for the dump\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (option->diff_file && (option->reverse_mode || option->buff_size == 0)) {
+        fprintf(stderr, "Error: diff cannot be combined with reverse mode or width 0\n");
+        exit(EXIT_FAILURE);
+    }
+
     if (option->raw) {
         option->color = false;
         option->ascii = false;
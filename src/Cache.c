@@ -0,0 +1,303 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+/* Opt-in sidecar cache of block summaries (--cache).
+ * How it works:
+ * - The file is split into CACHE_BLOCK_SIZE blocks. Every block keeps its XXH64 and its
+ *   256 byte counts, which is enough to rebuild histograms, entropy and zero ratios.
+ * - The sidecar (<file>.hxcache) is keyed by device, inode, size and mtime. On a match
+ *   every summary and the magic result are trusted and no byte of the input is read.
+ * - On a mismatch the old summaries become stale: each block is hashed again and only
+ *   blocks whose digest changed get a new histogram.
+ * - The sidecar is rewritten through a temporary file. A read-only directory just
+ *   means the next run recomputes, errors are never reported.
+ */
+
+#include "Cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "DisplayUtils.h"
+#include "File.h"
+#include "Hash.h"
+#include "Threads.h"
+
+// On-disk header, followed by block_count cache_block records in native byte order.
+typedef struct {
+    char magic[8];
+    uint32_t block_size;
+    uint32_t magic_valid;
+    cache_key key;
+    uint64_t block_count;
+    unsigned char magic_flags[256];
+} cache_header;
+
+// Shared state for the revalidation workers.
+typedef struct {
+    const char *filename;
+    block_cache *cache;
+    size_t first;
+    size_t last;
+    size_t reused[MAX_WORKERS];
+    size_t computed[MAX_WORKERS];
+    size_t touched[MAX_WORKERS];   // Blocks that were not valid before this run
+} cache_job;
+
+static bool read_cache_key(const char *filename, cache_key *key) {
+    memset(key, 0, sizeof(*key));
+
+    #ifdef _WIN32
+    struct _stat64 st;
+    if (_stat64(filename, &st) != 0) return false;
+    #else
+    struct stat st;
+    if (stat(filename, &st) != 0) return false;
+    #endif
+
+    key->dev = (uint64_t)st.st_dev;
+    key->inode = (uint64_t)st.st_ino;
+    key->size = (uint64_t)st.st_size;
+    key->mtime_sec = (int64_t)st.st_mtime;
+
+    #if defined(__APPLE__)
+    key->mtime_nsec = (int64_t)st.st_mtimespec.tv_nsec;
+    #elif defined(__linux__)
+    key->mtime_nsec = (int64_t)st.st_mtim.tv_nsec;
+    #endif
+
+    return true;
+}
+
+static char *sidecar_path(const char *filename, const char *suffix) {
+    size_t len = strlen(filename) + strlen(CACHE_SUFFIX) + strlen(suffix) + 1;
+    char *path = malloc(len);
+    if (!path) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    snprintf(path, len, "%s%s%s", filename, CACHE_SUFFIX, suffix);
+    return path;
+}
+
+// Loads the sidecar if there is one. Returns false if the input itself cannot be stat'ed,
+// a missing or foreign sidecar just leaves every block empty.
+bool cache_open(block_cache *cache, const char *filename) {
+    memset(cache, 0, sizeof(*cache));
+    if (!read_cache_key(filename, &cache->key)) return false;
+
+    cache->block_count = (size_t)((cache->key.size + CACHE_BLOCK_SIZE - 1) / CACHE_BLOCK_SIZE);
+    cache->blocks = calloc(cache->block_count > 0 ? cache->block_count : 1, sizeof(cache_block));
+    if (!cache->blocks) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    char *path = sidecar_path(filename, "");
+    FILE *file = fopen(path, "rb");
+    free(path);
+    if (!file) return true;
+
+    cache_header header;
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.block_size != CACHE_BLOCK_SIZE) {
+        fclose(file);
+        return true;
+    }
+
+    cache->key_match = memcmp(&header.key, &cache->key, sizeof(cache_key)) == 0;
+
+    size_t stored = header.block_count < cache->block_count ? (size_t)header.block_count : cache->block_count;
+    size_t loaded = fread(cache->blocks, sizeof(cache_block), stored, file);
+    fclose(file);
+
+    // A short sidecar is only partly usable, the rest is computed again.
+    // Stale blocks stay stale until a run actually hashes them.
+    for (size_t i = 0; i < cache->block_count; i++) {
+        cache_block *blk = &cache->blocks[i];
+
+        if (i >= loaded || blk->state > CACHE_BLOCK_VALID || blk->state == CACHE_BLOCK_EMPTY) {
+            memset(blk, 0, sizeof(*blk));
+        } else if (!cache->key_match) {
+            blk->state = CACHE_BLOCK_STALE;
+        }
+    }
+
+    if (cache->key_match && header.magic_valid) {
+        cache->magic_valid = true;
+        memcpy(cache->magic, header.magic_flags, sizeof(cache->magic));
+    }
+
+    return true;
+}
+
+static void cache_worker(void *ctx, int worker_id, int worker_count) {
+    cache_job *job = (cache_job *)ctx;
+    block_cache *cache = job->cache;
+
+    size_t span = job->last - job->first;
+    size_t first = job->first + span * (size_t)worker_id / (size_t)worker_count;
+    size_t last = job->first + span * (size_t)(worker_id + 1) / (size_t)worker_count;
+
+    FILE *file = NULL;
+    unsigned char *chunk = NULL;
+    size_t file_pos = (size_t)-1;
+
+    for (size_t i = first; i < last; i++) {
+        cache_block *blk = &cache->blocks[i];
+        if (blk->state == CACHE_BLOCK_VALID) {
+            job->reused[worker_id]++;
+            continue;
+        }
+
+        // Open lazily, a fully valid slice never touches the input.
+        if (!file) {
+            file = fopen(job->filename, "rb");
+            chunk = malloc(CACHE_BLOCK_SIZE);
+            if (!file || !chunk) {
+                perror("Cache worker failed");
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        job->touched[worker_id]++;
+        size_t pos = i * (size_t)CACHE_BLOCK_SIZE;
+        if (file_pos != pos) file_seek(file, pos);
+
+        size_t want = (size_t)cache->key.size - pos < CACHE_BLOCK_SIZE ? (size_t)cache->key.size - pos : CACHE_BLOCK_SIZE;
+        size_t got = fread(chunk, 1, want, file);
+        file_pos = pos + got;
+
+        uint64_t digest = xxh64(chunk, got, 0);
+        if (blk->state == CACHE_BLOCK_STALE && blk->digest == digest) {
+            blk->state = CACHE_BLOCK_VALID;
+            job->reused[worker_id]++;
+            continue;
+        }
+
+        byte_histogram hist = {0};
+        histogram_update(&hist, chunk, got);
+        for (int b = 0; b < 256; b++) blk->counts[b] = (uint32_t)hist.counts[b];
+
+        blk->digest = digest;
+        blk->state = CACHE_BLOCK_VALID;
+        job->computed[worker_id]++;
+    }
+
+    free(chunk);
+    if (file) fclose(file);
+}
+
+// Makes blocks [first, last) valid: trusted blocks are kept, stale ones are hashed
+// and only recomputed when their content changed.
+void cache_prepare(block_cache *cache, const char *filename, size_t first, size_t last) {
+    if (last > cache->block_count) last = cache->block_count;
+    if (first >= last) return;
+
+    cache_job *job = calloc(1, sizeof(cache_job));
+    if (!job) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    job->filename = filename;
+    job->cache = cache;
+    job->first = first;
+    job->last = last;
+
+    // One worker per ANALYSIS_CHUNK_SIZE worth of blocks at most.
+    size_t per_chunk = ANALYSIS_CHUNK_SIZE / CACHE_BLOCK_SIZE;
+    size_t chunks = (last - first + per_chunk - 1) / per_chunk;
+    int workers = get_worker_count();
+    if ((size_t)workers > chunks) workers = (int)chunks;
+
+    run_workers(cache_worker, job, workers);
+
+    for (int i = 0; i < workers; i++) {
+        cache->reused += job->reused[i];
+        cache->computed += job->computed[i];
+        if (job->touched[i] > 0) cache->dirty = true;
+    }
+    if (!cache->key_match) cache->dirty = true;
+
+    free(job);
+}
+
+// Adds the counts of valid blocks [first, last) to hist.
+void cache_histogram(const block_cache *cache, size_t first, size_t last, byte_histogram *hist) {
+    if (last > cache->block_count) last = cache->block_count;
+
+    for (size_t i = first; i < last; i++) {
+        const cache_block *blk = &cache->blocks[i];
+
+        for (int b = 0; b < 256; b++) {
+            hist->counts[b] += blk->counts[b];
+            hist->total += blk->counts[b];
+        }
+    }
+}
+
+// Restores the magic result from the sidecar, or scans the header and remembers it.
+void cache_magic(block_cache *cache, const char *filename) {
+    if (cache->magic_valid) {
+        set_found_magic(cache->magic);
+        return;
+    }
+
+    FILE *file = fopen(filename, "rb");
+    if (!file) return;
+
+    find_magic_bytes_in_stream_header(file);
+    fclose(file);
+
+    get_found_magic(cache->magic);
+    cache->magic_valid = true;
+    cache->dirty = true;
+}
+
+// Writes the sidecar if anything changed. Failures leave the old sidecar in place.
+void cache_save(block_cache *cache, const char *filename) {
+    if (!cache->dirty || !cache->blocks) return;
+
+    cache_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.block_size = CACHE_BLOCK_SIZE;
+    header.magic_valid = cache->magic_valid ? 1 : 0;
+    header.key = cache->key;
+    header.block_count = cache->block_count;
+    memcpy(header.magic_flags, cache->magic, sizeof(header.magic_flags));
+
+    char *tmp_path = sidecar_path(filename, ".tmp");
+    char *path = sidecar_path(filename, "");
+
+    FILE *file = fopen(tmp_path, "wb");
+    if (file) {
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(cache->blocks, sizeof(cache_block), cache->block_count, file) == cache->block_count;
+        ok = fclose(file) == 0 && ok;
+
+        #ifdef _WIN32
+        if (ok) remove(path);
+        #endif
+        if (!ok || rename(tmp_path, path) != 0) remove(tmp_path);
+    }
+
+    free(tmp_path);
+    free(path);
+    cache->dirty = false;
+}
+
+void cache_close(block_cache *cache) {
+    free(cache->blocks);
+    cache->blocks = NULL;
+    cache->block_count = 0;
+}
@@ -150,7 +150,7 @@ static bool parse_output_mode(const char *value, int *out) {
 static char *expressions[] = {
     "output_mode", "heatmap", "width", "grouping",
     "show_ascii", "show_color", "string", "entropie", "toggle_header",
-    "skip_zero", "raw", "reverse", "CONTROL_COLOR", "NULL_BYTE_COLOR", "ADDR_COLOR",
+    "skip_zero", "squeeze", "raw", "reverse", "CONTROL_COLOR", "NULL_BYTE_COLOR", "ADDR_COLOR",
     "ASCII_COLOR", "EXTENDED_ASCII_COLOR", "HEADER_COLOR", "MAGIC_COLOR",
     "BORDER_COLOR", "ANALYSIS_TEXT_COLOR", "ERROR_COLOR", "HIGHLIGHT_COLOR"
 };
@@ -430,6 +430,14 @@ void set_config(options *opt) {
                     }
                 }
 
+                else if (strcmp(key, "squeeze") == 0) {
+                    if (parse_bool(value, &bool_value)) {
+                        opt->squeeze = bool_value;
+                    } else {
+                        fprintf(stderr, "Invalid value for squeeze: %s\n", value);
+                    }
+                }
+
                 else if (strcmp(key, "raw") == 0) {
                     if (parse_bool(value, &bool_value)) {
                         opt->raw = bool_value;
@@ -0,0 +1,51 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#include "Cpu.h"
+
+#if defined(HXED_X86)
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+static cpu_features features;
+
+// Queries CPUID. Called from main before any thread starts; until then (and on non-x86
+// targets) no extensions are reported and the portable code is used.
+void detect_cpu_features(void) {
+    #if defined(HXED_X86)
+    unsigned int leaf1_ecx = 0;
+    unsigned int leaf7_ebx = 0;
+
+    #if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0);
+    int max_leaf = regs[0];
+    __cpuid(regs, 1);
+    leaf1_ecx = (unsigned int)regs[2];
+    if (max_leaf >= 7) {
+        __cpuidex(regs, 7, 0);
+        leaf7_ebx = (unsigned int)regs[1];
+    }
+    #else
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) leaf1_ecx = ecx;
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) leaf7_ebx = ebx;
+    #endif
+
+    features.pclmul = (leaf1_ecx >> 1) & 1;
+    features.sse42 = (leaf1_ecx >> 20) & 1;
+    features.sha = (leaf7_ebx >> 29) & 1;
+    #endif
+}
+
+const cpu_features *get_cpu_features(void) {
+    return &features;
+}
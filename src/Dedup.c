@@ -0,0 +1,290 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+/* Duplicate content report (--dedup-report).
+ * How it works:
+ * - A Gear rolling hash with FastCDC normalized chunking cuts the range into chunks
+ *   whose boundaries depend on content, so repeated data yields identical chunks
+ *   even when it is not aligned to any block size.
+ * - Every chunk is hashed (XXH64) and counted in an open addressing index.
+ * - The index has a fixed upper size; once it is full, new unique chunks are only
+ *   counted, while duplicates of already indexed chunks are still found.
+ */
+
+#include "Dedup.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "DisplayUtils.h"
+#include "File.h"
+#include "Hash.h"
+#include "Utils.h"
+
+#define DEDUP_BUFFER_SIZE (4 << 20)
+
+// One distinct chunk of the index.
+typedef struct {
+    uint64_t digest;
+    uint32_t length;
+    uint32_t count;                 // 0 = empty slot
+    uint64_t offsets[DEDUP_OFFSETS];
+} dedup_entry;
+
+typedef struct {
+    dedup_entry *entries;
+    size_t capacity;                // Power of two
+    size_t used;
+    bool full;                      // Cap reached, unique chunks are no longer inserted
+} dedup_index;
+
+static inline uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Sets up chunk sizes (min = avg / 4, max = avg * 8) and a fixed pseudo random gear table.
+// The masks take the top bits of the fingerprint, which depend on the last 64 bytes.
+void cdc_init(cdc_params *params, size_t avg_size) {
+    uint64_t seed = 0x6878656463646331ULL;
+    for (int i = 0; i < 256; i++) {
+        params->gear[i] = splitmix64(&seed);
+    }
+
+    int bits = 0;
+    while (((size_t)1 << (bits + 1)) <= avg_size) bits++;
+
+    params->avg_size = (size_t)1 << bits;
+    params->min_size = params->avg_size / 4;
+    params->max_size = params->avg_size * 8;
+    params->mask_small = ~0ULL << (64 - (bits + 2));
+    params->mask_large = ~0ULL << (64 - (bits - 2));
+}
+
+// Length of the next chunk at data, or 0 if more input is needed to decide.
+size_t cdc_next_cut(const cdc_params *params, const unsigned char *data, size_t len, bool eof) {
+    if (len <= params->min_size) return eof ? len : 0;
+
+    size_t n = len < params->max_size ? len : params->max_size;
+    size_t normal = n < params->avg_size ? n : params->avg_size;
+    uint64_t fp = 0;
+    size_t i = params->min_size;
+
+    for (; i < normal; i++) {
+        fp = (fp << 1) + params->gear[data[i]];
+        if (!(fp & params->mask_small)) return i + 1;
+    }
+
+    for (; i < n; i++) {
+        fp = (fp << 1) + params->gear[data[i]];
+        if (!(fp & params->mask_large)) return i + 1;
+    }
+
+    if (n == params->max_size) return n;
+    return eof ? len : 0;
+}
+
+static void index_grow(dedup_index *index) {
+    size_t new_capacity = index->capacity ? index->capacity * 2 : 4096;
+    dedup_entry *entries = calloc(new_capacity, sizeof(dedup_entry));
+    if (!entries) {
+        perror("Malloc failed for dedup index");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < index->capacity; i++) {
+        dedup_entry *old = &index->entries[i];
+        if (old->count == 0) continue;
+
+        size_t slot = (size_t)old->digest & (new_capacity - 1);
+        while (entries[slot].count != 0) slot = (slot + 1) & (new_capacity - 1);
+        entries[slot] = *old;
+    }
+
+    free(index->entries);
+    index->entries = entries;
+    index->capacity = new_capacity;
+}
+
+// Counts one chunk, returns true if it was already in the index.
+static bool index_add(dedup_index *index, uint64_t digest, uint32_t length, size_t offset) {
+    // Keep the load factor at or below 1/2, or 3/4 once the size cap is reached.
+    if (!index->full && (index->used + 1) * 2 > index->capacity) {
+        if (index->capacity < DEDUP_MAX_ENTRIES) index_grow(index);
+        else if ((index->used + 1) * 4 > index->capacity * 3) index->full = true;
+    }
+
+    size_t slot = (size_t)digest & (index->capacity - 1);
+    while (index->entries[slot].count != 0) {
+        dedup_entry *entry = &index->entries[slot];
+        if (entry->digest == digest && entry->length == length) {
+            if (entry->count < DEDUP_OFFSETS) entry->offsets[entry->count] = (uint64_t)offset;
+            entry->count++;
+            return true;
+        }
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+
+    if (index->full) return false;
+
+    dedup_entry *entry = &index->entries[slot];
+    entry->digest = digest;
+    entry->length = length;
+    entry->count = 1;
+    entry->offsets[0] = (uint64_t)offset;
+    index->used++;
+    return false;
+}
+
+static size_t redundant_bytes(const dedup_entry *entry) {
+    return (size_t)(entry->count - 1) * entry->length;
+}
+
+static int compare_redundancy(const void *a, const void *b) {
+    size_t ra = redundant_bytes(*(const dedup_entry *const *)a);
+    size_t rb = redundant_bytes(*(const dedup_entry *const *)b);
+    return (ra < rb) - (ra > rb);
+}
+
+// --dedup-report: content-defined chunking over the range and a list of repeated chunks.
+void print_dedup_report(options *option) {
+    FILE *out = stdout;
+    FILE *file = open_input_file(option);
+    size_t start = option->offset_read;
+    size_t end = get_read_end(option);
+
+    cdc_params params;
+    cdc_init(&params, option->dedup_avg);
+
+    dedup_index index = {0};
+    index_grow(&index);
+
+    unsigned char *buf = malloc(DEDUP_BUFFER_SIZE);
+    if (!buf) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    range_reader reader;
+    range_reader_init(&reader, file, option->pipeline, start, end);
+
+    size_t head = 0;
+    size_t tail = 0;
+    size_t offset = start;
+    size_t chunk_count = 0;
+    size_t duplicate_chunks = 0;
+    size_t redundant = 0;
+    bool eof = false;
+
+    while (1) {
+        size_t cut = cdc_next_cut(&params, buf + head, tail - head, eof);
+
+        if (cut == 0) {
+            if (eof) break;
+
+            // Move the undecided tail to the front and refill (it is shorter than max_size).
+            memmove(buf, buf + head, tail - head);
+            tail -= head;
+            head = 0;
+
+            size_t got = range_reader_read(&reader, buf + tail, DEDUP_BUFFER_SIZE - tail);
+            if (got == 0) eof = true;
+            tail += got;
+            continue;
+        }
+
+        uint64_t digest = xxh64(buf + head, cut, 0);
+        if (index_add(&index, digest, (uint32_t)cut, offset)) {
+            duplicate_chunks++;
+            redundant += cut;
+        }
+
+        chunk_count++;
+        offset += cut;
+        head += cut;
+    }
+
+    free(buf);
+    if (!option->pipeline) fclose(file);
+
+    // Collect and rank the duplicate groups.
+    size_t group_count = 0;
+    for (size_t i = 0; i < index.capacity; i++) {
+        if (index.entries[i].count > 1) group_count++;
+    }
+
+    dedup_entry **groups = malloc((group_count > 0 ? group_count : 1) * sizeof(dedup_entry *));
+    if (!groups) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t g = 0;
+    for (size_t i = 0; i < index.capacity; i++) {
+        if (index.entries[i].count > 1) groups[g++] = &index.entries[i];
+    }
+    qsort(groups, group_count, sizeof(dedup_entry *), compare_redundancy);
+
+    int addr_width = _hex_digits_size_t(offset);
+    if (addr_width < 8) addr_width = 8;
+    int row_width = addr_width + 3 + 8 + 3 + 7 + 3 + 12 + 3 + 40;
+
+    if (option->color) fprintf(out, "%s", HEADER_COLOR);
+    fprintf(out, "\ndedup report for %s (chunks %zu-%zu B, avg %zu B):\n",
+            option->pipeline ? "<pipe>" : option->filename, params.min_size, params.max_size, params.avg_size);
+    fprintf(out, "%-*s | %8s | %7s | %12s | %s\n", addr_width, "offset", "length", "copies", "redundant", "also at");
+    if (option->color) fprintf(out, "%s", BORDER_COLOR);
+    for (int i = 0; i < row_width; i++) fputc('-', out);
+    if (option->color) fprintf(out, "%s", RESET);
+    fputc('\n', out);
+
+    for (size_t i = 0; i < group_count && i < (size_t)option->top_n; i++) {
+        const dedup_entry *entry = groups[i];
+        char also[MAX_LINE_SIZE] = {0};
+        size_t also_pos = 0;
+
+        uint32_t listed = entry->count < DEDUP_OFFSETS ? entry->count : DEDUP_OFFSETS;
+        for (uint32_t k = 1; k < listed; k++) {
+            append_to_line(also, sizeof(also), &also_pos, "%0*llX ", addr_width, (unsigned long long)entry->offsets[k]);
+        }
+        if (entry->count > DEDUP_OFFSETS) {
+            append_to_line(also, sizeof(also), &also_pos, "(+%u)", entry->count - DEDUP_OFFSETS);
+        }
+
+        if (option->color) {
+            fprintf(out, "%s%0*llX %s| %s%8u %s| %s%7u %s| %s%12zu %s| %s%s%s\n",
+                    ADDR_COLOR, addr_width, (unsigned long long)entry->offsets[0], BORDER_COLOR,
+                    ANALYSIS_TEXT_COLOR, entry->length, BORDER_COLOR,
+                    ANALYSIS_TEXT_COLOR, entry->count, BORDER_COLOR,
+                    MAGIC_COLOR, redundant_bytes(entry), BORDER_COLOR,
+                    ADDR_COLOR, also, RESET);
+        } else {
+            fprintf(out, "%0*llX | %8u | %7u | %12zu | %s\n",
+                    addr_width, (unsigned long long)entry->offsets[0], entry->length, entry->count,
+                    redundant_bytes(entry), also);
+        }
+    }
+
+    if (option->color) fprintf(out, "%s", BORDER_COLOR);
+    for (int i = 0; i < row_width; i++) fputc('-', out);
+    if (option->color) fprintf(out, "%s", RESET);
+    fputc('\n', out);
+
+    size_t total = offset - start;
+    print_report_row(out, option, "dedup", "chunks %zu ; duplicate chunks %zu ; groups %zu ; redundant %zu B (%.1f%%)",
+                     chunk_count, duplicate_chunks, group_count, redundant,
+                     total ? redundant * 100.0 / (double)total : 0.0);
+    print_report_row(out, option, "view", "size %zu B ; offset %zu ; index %zu entries%s",
+                     total, start, index.used, index.full ? " (full, later unique chunks not indexed)" : "");
+    fputc('\n', out);
+
+    free(groups);
+    free(index.entries);
+}
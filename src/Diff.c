@@ -0,0 +1,445 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+/* Binary comparison of two files (--diff A B).
+ * How it works:
+ * - Both files are memory mapped. Workers hash fixed blocks of both files (XXH64)
+ *   in parallel; everything before the first differing block is equal and skipped.
+ *   The equal tail is found by comparing backwards from both ends.
+ * - The remaining middle of each file is cut into content-defined chunks (the Gear /
+ *   FastCDC chunker of the dedup report). Chunk boundaries depend on content only,
+ *   so they line up again after inserted or deleted bytes and act as anchors.
+ * - The two chunk sequences are aligned greedily: equal chunks are matched, and on a
+ *   mismatch the nearest later occurrence of either chunk decides which side skips.
+ *   Per-hash cursors only move forward, so the alignment stays linear.
+ * - Unmatched spans become insert, delete or modify regions, trimmed to the exact
+ *   differing bytes, and are printed side by side with the changed bytes highlighted.
+ */
+
+#include "Diff.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Dedup.h"
+#include "DisplayUtils.h"
+#include "File.h"
+#include "Hash.h"
+#include "Sink.h"
+#include "Threads.h"
+#include "Utils.h"
+
+// Shared state for the hash workers, one flag per block.
+typedef struct {
+    const unsigned char *a;
+    const unsigned char *b;
+    size_t start;
+    size_t end;
+    size_t block_count;
+    unsigned char *differs;
+} diff_job;
+
+// One content-defined chunk of the middle part of a file.
+typedef struct {
+    size_t offset;
+    size_t length;
+    uint64_t digest;
+} diff_chunk;
+
+// Hash slot of an anchor index: first chunk with this digest and a forward-only cursor.
+typedef struct {
+    uint64_t digest;
+    uint32_t first;         // Chunk index + 1, 0 = empty slot
+    uint32_t cursor;        // Last chunk index + 1 returned by a lookup
+} anchor_slot;
+
+typedef struct {
+    diff_chunk *chunks;
+    size_t count;
+    uint32_t *next_same;    // Next chunk index + 1 with the same digest, 0 = none
+    anchor_slot *slots;
+    size_t slot_mask;
+} anchor_list;
+
+// Output state while rendering changed regions.
+typedef struct {
+    FILE *out;
+    const options *option;
+    const unsigned char *a;
+    const unsigned char *b;
+    int addr_width;
+    size_t lines;
+    size_t changed_bytes;
+    size_t regions[3];      // insert, delete, modify
+} diff_render;
+
+enum { REGION_INSERT, REGION_DELETE, REGION_MODIFY };
+
+static const char *region_names[3] = {"insert", "delete", "modify"};
+
+// Worker: compares the hashes of a contiguous run of blocks.
+static void diff_hash_worker(void *ctx, int worker_id, int worker_count) {
+    diff_job *job = (diff_job *)ctx;
+    size_t first = job->block_count * (size_t)worker_id / (size_t)worker_count;
+    size_t last = job->block_count * (size_t)(worker_id + 1) / (size_t)worker_count;
+
+    for (size_t blk = first; blk < last; blk++) {
+        size_t pos = job->start + blk * DIFF_BLOCK_SIZE;
+        size_t len = job->end - pos < DIFF_BLOCK_SIZE ? job->end - pos : DIFF_BLOCK_SIZE;
+
+        job->differs[blk] = xxh64(job->a + pos, len, 0) != xxh64(job->b + pos, len, 0);
+    }
+}
+
+// Appends the address column of one side, blank if the side has no bytes on this line.
+static void append_diff_addr(char *line, size_t *line_pos, const diff_render *render, size_t pos, size_t len) {
+    const options *option = render->option;
+
+    if (len == 0) {
+        append_to_line(line, MAX_LINE_SIZE, line_pos, "%*s %s| %s", render->addr_width, "",
+                       option->color ? BORDER_COLOR : "", option->color ? RESET : "");
+    } else if (option->color) {
+        append_to_line(line, MAX_LINE_SIZE, line_pos, "%s%0*zX %s| %s",
+                       ADDR_COLOR, render->addr_width, pos, BORDER_COLOR, RESET);
+    } else {
+        append_to_line(line, MAX_LINE_SIZE, line_pos, "%0*zX | ", render->addr_width, pos);
+    }
+}
+
+// Renders one line pair (A at pos_a, B at pos_b). Equal pairs are skipped when
+// skip_equal is set. Returns true if the line was printed.
+static bool render_diff_line(diff_render *render, size_t pos_a, size_t len_a, size_t pos_b, size_t len_b, bool skip_equal) {
+    const options *option = render->option;
+    const unsigned char *a = render->a + pos_a;
+    const unsigned char *b = render->b + pos_b;
+    size_t common = len_a < len_b ? len_a : len_b;
+
+    if (skip_equal && len_a == len_b && memcmp(a, b, common) == 0) return false;
+
+    for (size_t i = 0; i < common; i++) {
+        if (a[i] != b[i]) render->changed_bytes++;
+    }
+    render->changed_bytes += (len_a > len_b ? len_a : len_b) - common;
+
+    char line[MAX_LINE_SIZE];
+    size_t line_pos = 0;
+    line[0] = '\0';
+
+    append_diff_addr(line, &line_pos, render, pos_a, len_a);
+    append_compare_side(line, &line_pos, option, 0, a, len_a, b, len_b);
+    append_diff_addr(line, &line_pos, render, pos_b, len_b);
+    append_compare_side(line, &line_pos, option, 0, b, len_b, a, len_a);
+
+    fprintf(render->out, "%s\n", line);
+    render->lines++;
+    return true;
+}
+
+// Prints one region: a label row with both offsets, then its lines. Equal sized
+// modifications only show lines that changed.
+static void render_region(diff_render *render, size_t a_off, size_t a_len, size_t b_off, size_t b_len) {
+    const options *option = render->option;
+    size_t width = (size_t)option->buff_size;
+    int kind = a_len == 0 ? REGION_INSERT : b_len == 0 ? REGION_DELETE : REGION_MODIFY;
+
+    render->regions[kind]++;
+
+    if (!option->raw) {
+        print_report_row(render->out, option, region_names[kind], "A 0x%zX +%zu ; B 0x%zX +%zu",
+                         a_off, a_len, b_off, b_len);
+    }
+
+    size_t longest = a_len > b_len ? a_len : b_len;
+    for (size_t rel = 0; rel < longest; rel += width) {
+        size_t len_a = rel < a_len ? a_len - rel : 0;
+        size_t len_b = rel < b_len ? b_len - rel : 0;
+        if (len_a > width) len_a = width;
+        if (len_b > width) len_b = width;
+
+        render_diff_line(render, a_off + rel, len_a, b_off + rel, len_b, a_len == b_len);
+    }
+}
+
+// Trims the bytes both spans share at their start and end, then renders what is left.
+static void emit_region(diff_render *render, size_t a_off, size_t a_end, size_t b_off, size_t b_end) {
+    while (a_off < a_end && b_off < b_end && render->a[a_off] == render->b[b_off]) {
+        a_off++;
+        b_off++;
+    }
+
+    while (a_end > a_off && b_end > b_off && render->a[a_end - 1] == render->b[b_end - 1]) {
+        a_end--;
+        b_end--;
+    }
+
+    if (a_off == a_end && b_off == b_end) return;
+    render_region(render, a_off, a_end - a_off, b_off, b_end - b_off);
+}
+
+// Cuts [start, end) into content-defined chunks and indexes them by digest.
+static void collect_anchors(anchor_list *list, const unsigned char *data, size_t start, size_t end, const cdc_params *params) {
+    size_t capacity = (end - start) / params->min_size + 2;
+    list->chunks = malloc(capacity * sizeof(diff_chunk));
+    list->next_same = calloc(capacity, sizeof(uint32_t));
+    list->count = 0;
+
+    size_t slot_count = 1024;
+    while (slot_count < capacity * 2) slot_count <<= 1;
+    list->slots = calloc(slot_count, sizeof(anchor_slot));
+    list->slot_mask = slot_count - 1;
+
+    if (!list->chunks || !list->next_same || !list->slots) {
+        perror("Malloc failed for diff anchors");
+        exit(EXIT_FAILURE);
+    }
+
+    // Last chunk per digest, only needed while linking next_same.
+    uint32_t *last = calloc(slot_count, sizeof(uint32_t));
+    if (!last) {
+        perror("Malloc failed for diff anchors");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t pos = start;
+    while (pos < end) {
+        size_t len = cdc_next_cut(params, data + pos, end - pos, true);
+        uint32_t index = (uint32_t)list->count;
+        diff_chunk *chunk = &list->chunks[list->count++];
+
+        chunk->offset = pos;
+        chunk->length = len;
+        chunk->digest = xxh64(data + pos, len, 0);
+
+        size_t slot = (size_t)chunk->digest & list->slot_mask;
+        while (list->slots[slot].first != 0 && list->slots[slot].digest != chunk->digest) {
+            slot = (slot + 1) & list->slot_mask;
+        }
+
+        if (list->slots[slot].first == 0) {
+            list->slots[slot].digest = chunk->digest;
+            list->slots[slot].first = index + 1;
+            list->slots[slot].cursor = index + 1;
+        } else {
+            list->next_same[last[slot] - 1] = index + 1;
+        }
+        last[slot] = index + 1;
+        pos += len;
+    }
+
+    free(last);
+}
+
+// First chunk index >= from with the given digest, or (size_t)-1. Queries per digest
+// come with a growing from, so the cursor never walks the same chain twice.
+static size_t next_occurrence(anchor_list *list, uint64_t digest, size_t from) {
+    size_t slot = (size_t)digest & list->slot_mask;
+    while (list->slots[slot].first != 0 && list->slots[slot].digest != digest) {
+        slot = (slot + 1) & list->slot_mask;
+    }
+
+    anchor_slot *entry = &list->slots[slot];
+    if (entry->first == 0) return (size_t)-1;
+
+    uint32_t index = entry->cursor;
+    while (index != 0 && index - 1 < from) index = list->next_same[index - 1];
+    if (index == 0) return (size_t)-1;
+
+    entry->cursor = index;
+    return index - 1;
+}
+
+static void free_anchors(anchor_list *list) {
+    free(list->chunks);
+    free(list->next_same);
+    free(list->slots);
+}
+
+// Aligns the chunk sequences of both middles and emits every unmatched span.
+static size_t align_middle(diff_render *render, size_t a_start, size_t a_end, size_t b_start, size_t b_end) {
+    size_t span = (a_end - a_start) > (b_end - b_start) ? a_end - a_start : b_end - b_start;
+    size_t avg = DIFF_ANCHOR_AVG;
+    while (span / avg > DIFF_MAX_ANCHORS && avg < 262144) avg *= 2;
+
+    cdc_params params;
+    cdc_init(&params, avg);
+
+    anchor_list list_a, list_b;
+    collect_anchors(&list_a, render->a, a_start, a_end, &params);
+    collect_anchors(&list_b, render->b, b_start, b_end, &params);
+
+    size_t i = 0, j = 0;
+    size_t pending_a = 0, pending_b = 0;    // First unmatched chunk of the open region
+
+    while (i < list_a.count && j < list_b.count) {
+        const diff_chunk *ca = &list_a.chunks[i];
+        const diff_chunk *cb = &list_b.chunks[j];
+
+        if (ca->digest == cb->digest && ca->length == cb->length &&
+            memcmp(render->a + ca->offset, render->b + cb->offset, ca->length) == 0) {
+            if (pending_a < i || pending_b < j) {
+                emit_region(render, list_a.chunks[pending_a].offset, ca->offset,
+                            list_b.chunks[pending_b].offset, cb->offset);
+            }
+            i++;
+            j++;
+            pending_a = i;
+            pending_b = j;
+            continue;
+        }
+
+        // Resynchronize on whichever anchor reappears first on the other side.
+        size_t in_b = next_occurrence(&list_b, ca->digest, j);
+        size_t in_a = next_occurrence(&list_a, cb->digest, i);
+        size_t skip_b = in_b == (size_t)-1 ? (size_t)-1 : in_b - j;
+        size_t skip_a = in_a == (size_t)-1 ? (size_t)-1 : in_a - i;
+
+        if (skip_a == (size_t)-1 && skip_b == (size_t)-1) {
+            i++;
+            j++;
+        } else if (skip_a <= skip_b) {
+            i = in_a;
+        } else {
+            j = in_b;
+        }
+    }
+
+    size_t tail_a = pending_a < list_a.count ? list_a.chunks[pending_a].offset : a_end;
+    size_t tail_b = pending_b < list_b.count ? list_b.chunks[pending_b].offset : b_end;
+    emit_region(render, tail_a, a_end, tail_b, b_end);
+
+    size_t anchors = list_a.count + list_b.count;
+    free_anchors(&list_a);
+    free_anchors(&list_b);
+    return anchors;
+}
+
+static void map_diff_input(const char *path, mapped_file *map) {
+    if (!map_file(path, map)) {
+        fprintf(stderr, "Cant open / map diff input: %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+}
+
+void print_diff(options *option) {
+    mapped_file map_a, map_b;
+
+    map_diff_input(option->filename, &map_a);
+    map_diff_input(option->diff_file, &map_b);
+
+    // Same range in both files, each clamped to its own size.
+    size_t start = option->offset_read;
+    size_t end = get_read_end(option);
+    size_t end_a = (end == 0 || end > map_a.size) ? map_a.size : end;
+    size_t end_b = (end == 0 || end > map_b.size) ? map_b.size : end;
+    if (end_a < start) end_a = start;
+    if (end_b < start) end_b = start;
+
+    size_t common_end = end_a < end_b ? end_a : end_b;
+
+    // Equal prefix: blocks at the same offset, hashed in parallel.
+    diff_job job = {0};
+    job.a = map_a.data;
+    job.b = map_b.data;
+    job.start = start;
+    job.end = common_end;
+    job.block_count = (common_end - start + DIFF_BLOCK_SIZE - 1) / DIFF_BLOCK_SIZE;
+    job.differs = calloc(job.block_count + 1, 1);
+    if (!job.differs) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    int workers = get_worker_count();
+    if ((size_t)workers > job.block_count) workers = job.block_count > 0 ? (int)job.block_count : 1;
+    if (job.block_count > 0) run_workers(diff_hash_worker, &job, workers);
+
+    size_t differing_blocks = 0;
+    size_t first_diff = job.block_count;
+    for (size_t blk = 0; blk < job.block_count; blk++) {
+        if (!job.differs[blk]) continue;
+        if (first_diff == job.block_count) first_diff = blk;
+        differing_blocks++;
+    }
+
+    size_t mid_a = start + first_diff * DIFF_BLOCK_SIZE;
+    if (mid_a > common_end) mid_a = common_end;
+    size_t mid_b = mid_a;
+
+    // Equal suffix: compared backwards from both ends, block-wise and then per byte.
+    size_t tail_a = end_a, tail_b = end_b;
+    while (tail_a - mid_a >= DIFF_BLOCK_SIZE && tail_b - mid_b >= DIFF_BLOCK_SIZE &&
+           memcmp(map_a.data + tail_a - DIFF_BLOCK_SIZE, map_b.data + tail_b - DIFF_BLOCK_SIZE, DIFF_BLOCK_SIZE) == 0) {
+        tail_a -= DIFF_BLOCK_SIZE;
+        tail_b -= DIFF_BLOCK_SIZE;
+    }
+    while (tail_a > mid_a && tail_b > mid_b && map_a.data[tail_a - 1] == map_b.data[tail_b - 1]) {
+        tail_a--;
+        tail_b--;
+    }
+
+    // Same sinks as the dump: stdout, or the pager (which falls back to stdout).
+    output_sink sink;
+    sink_stdout(&sink);
+    if (option->pager) sink_open_pager(&sink);
+    FILE *out = sink.stream;
+
+    diff_render render = {0};
+    render.out = out;
+    render.option = option;
+    render.a = map_a.data;
+    render.b = map_b.data;
+    render.addr_width = _hex_digits_size_t(end_a > end_b ? end_a : end_b);
+    if (render.addr_width < 8) render.addr_width = 8;
+
+    bool show_frame = !option->raw && !option->skip_header;
+    int row_width = 2 * (render.addr_width + 3 + compare_side_width(option));
+
+    if (show_frame) {
+        if (option->color) fprintf(out, "%s", HEADER_COLOR);
+        fprintf(out, "\ndiff %s <-> %s:\n", option->filename, option->diff_file);
+        if (option->color) fprintf(out, "%s", BORDER_COLOR);
+        for (int i = 0; i < row_width; i++) fputc('-', out);
+        if (option->color) fprintf(out, "%s", RESET);
+        fputc('\n', out);
+    }
+
+    size_t anchors = 0;
+    if (tail_a > mid_a || tail_b > mid_b) {
+        anchors = align_middle(&render, mid_a, tail_a, mid_b, tail_b);
+    }
+
+    if (show_frame) {
+        if (option->color) fprintf(out, "%s", BORDER_COLOR);
+        for (int i = 0; i < row_width; i++) fputc('-', out);
+        if (option->color) fprintf(out, "%s", RESET);
+        fputc('\n', out);
+
+        print_report_row(out, option, "diff", "insert %zu ; delete %zu ; modify %zu ; lines %zu ; bytes changed %zu",
+                         render.regions[REGION_INSERT], render.regions[REGION_DELETE], render.regions[REGION_MODIFY],
+                         render.lines, render.changed_bytes);
+        print_report_row(out, option, "sync", "equal prefix %zu B ; equal suffix %zu B ; anchors %zu ; blocks %zu/%zu differ",
+                         mid_a - start, end_a - tail_a, anchors, differing_blocks, job.block_count);
+        print_report_row(out, option, "files", "A %zu B ; B %zu B%s",
+                         map_a.size, map_b.size, map_a.size == map_b.size ? "" : " ; sizes differ");
+        print_report_row(out, option, "view", "width %d ; offset %zu ; limit A %zu ; limit B %zu ; workers %d",
+                         option->buff_size, start, end_a, end_b, workers);
+        fputc('\n', out);
+    }
+
+    int write_error = ferror(out) ? (errno ? errno : EIO) : 0;
+    int close_error = sink_close(&sink);
+    if (!write_error) write_error = close_error;
+
+    free(job.differs);
+    unmap_file(&map_a);
+    unmap_file(&map_b);
+
+    if (write_error) exit(sink_exit_status(write_error));
+}
@@ -7,10 +7,20 @@
 
 /* Implementation of the display functions for the hex dumper 
  * How it works:
- * - Reads the input file in chunks defined by buff_size.
+ * - Reads the input file in chunks defined by buff_size. Standard input goes through a
+ *   ring buffer (see File.c) that hands out whole chunks, whatever sizes the pipe delivers.
  * - For each chunk, it constructs a formatted line of output based on the selected output mode (hex, octal, binary, decimal).
  * - Applies coloring based on heatmap, string, or color options.
  * - At the end of the dump, it prints a footer with a summary of the analysis and metadata.
+ * - With --jobs, batches of chunks are formatted on worker threads into per-chunk text
+ *   buffers, which are written in address order.
+ * - Rendered lines go to a writer thread in large buffers (see Writer.c), so a slow
+ *   terminal or pipe does not stall formatting. The thread writes them to an output sink
+ *   (see Sink.c) with writev. A failed write stops the dump within one chunk; when the
+ *   pager or the next command in the pipe exits, hxed cleans up and exits quietly.
+ * - Holes of sparse files are found with SEEK_DATA/SEEK_HOLE (see File.c). Whole read
+ *   units inside a hole are not read: one row stands in for them, and they are counted as
+ *   zeros in the footer and the digests.
  */
 
 #include <stdbool.h>
@@ -24,7 +34,14 @@
 #include "DisplayUtils.h"
 #include "Args.h"
 #include "File.h"
+#include "Threads.h"
+#include "Sink.h"
 #include "Utils.h"
+#include "Writer.h"
+
+#define RENDER_UNITS_PER_JOB 16         // Read units (MAX_BUFF_SIZE each) per worker and batch
+#define RANGE_MERGE_GAP (64 * 1024)     // --range regions closer than this share one read
+#define RANGE_SPAN_MAX (4 * 1024 * 1024) // Largest merged --range read held in memory
 
 typedef struct {
     unsigned char *data;
@@ -237,9 +254,69 @@ static decoded_bytes decode_reverse_stream(FILE *file, const options *option) {
     return decoded;
 }
 
-static void print_reverse(options *option, FILE *file, display_state *state, dump_analysis *analysis) {
+// The byte class counters are only shown in the footer, raw and -th output skip them.
+static inline bool needs_analysis(const options *option) {
+    return !option->raw && !option->skip_header;
+}
+
+// Holes are skipped where one row can stand in for their lines: not in raw output, which
+// must stay byte exact, and not with -se, where matching lines come from the data.
+static inline bool skips_holes(const options *option) {
+    return !option->pipeline && !option->raw && option->search_len == 0 && option->range_count == 0;
+}
+
+// Bytes at pos that are skipped as a hole: whole read units, so the following reads and
+// lines keep their addresses, or everything up to the end of the range.
+static size_t hole_at(hole_probe *holes, size_t pos, size_t end) {
+    size_t hole = hole_probe_skip(holes, pos, end);
+    if (pos + hole >= end) return hole;
+    return hole - hole % MAX_BUFF_SIZE;
+}
+
+// Stands in for reading len zero bytes: one row in the dump, zeros in the footer
+// statistics and the digests.
+static void skip_hole(const options *option, display_state *state, dump_analysis *analysis, digest_set *digests, size_t len) {
+    static const unsigned char zeros[MAX_BUFF_SIZE];
+    size_t width = (size_t)option->buff_size;
+
+    render_hole(state, len);
+
+    if (needs_analysis(option)) {
+        analysis->zero_bytes += len;
+        analysis->total_bytes += len;
+    }
+    for (size_t done = 0; digests->mask && done < len; done += MAX_BUFF_SIZE) {
+        digest_set_update(digests, zeros, len - done < MAX_BUFF_SIZE ? len - done : MAX_BUFF_SIZE);
+    }
+    // Every read unit starts a new line, so the lines are counted per unit.
+    size_t rest = len % MAX_BUFF_SIZE;
+    analysis->line_count += len / MAX_BUFF_SIZE * ((MAX_BUFF_SIZE + width - 1) / width) + (rest + width - 1) / width;
+    state->addr_display += len;
+}
+
+// Renders one read unit (at most MAX_BUFF_SIZE bytes) that is already in memory, with
+// the same lines, statistics and digests as the sequential loop.
+static void render_chunk(const options *option, display_state *state, dump_analysis *analysis, digest_set *digests, unsigned char *data, size_t chunk) {
+    state->data = data;
+    if (needs_analysis(option)) analyse(analysis, data, chunk);
+    if (digests->mask) digest_set_update(digests, data, chunk);
+
+    int processed = 0;
+    while ((size_t)processed < chunk) {
+        int line_len = option->buff_size;
+        if ((size_t)processed + (size_t)line_len > chunk) {
+            line_len = (int)(chunk - (size_t)processed);
+        }
+
+        analysis->line_count++;
+        render_line(state, processed, line_len);
+        state->addr_display += (size_t)line_len;
+        processed += line_len;
+    }
+}
+
+static void print_reverse(options *option, FILE *file, display_state *state, output_writer *writer, dump_analysis *analysis, digest_set *digests) {
     decoded_bytes decoded = decode_reverse_stream(file, option);
-    unsigned char *display_buffer = get_display_buffer();
 
     size_t start = option->offset_read;
     if (start > decoded.len) start = decoded.len;
@@ -259,26 +336,234 @@ static void print_reverse(options *option, FILE *file, display_state *state, dum
         size_t chunk = end - pos;
         if (chunk > MAX_BUFF_SIZE) chunk = MAX_BUFF_SIZE;
 
-        memcpy(display_buffer, decoded.data + pos, chunk);
-        analyse(analysis, display_buffer, chunk);
+        render_chunk(option, state, analysis, digests, decoded.data + pos, chunk);
+        pos += chunk;
+        if (!writer_submit(writer)) break;
+    }
 
-        int processed = 0;
-        while ((size_t)processed < chunk) {
-            int line_len = option->buff_size;
-            if ((size_t)processed + (size_t)line_len > chunk) {
-                line_len = (int)(chunk - (size_t)processed);
+    free(decoded.data);
+}
+
+// Shared state of the render workers: a batch of read units, each rendered on its own
+// display_state into its own text buffer.
+typedef struct {
+    const display_state *base;
+    unsigned char *data;        // Unit u starts at data + u * MAX_BUFF_SIZE
+    size_t *unit_len;
+    size_t *unit_addr;
+    text_buffer *text;
+    squeeze_state *squeeze;     // --squeeze state at the start of each unit
+    size_t unit_count;
+} render_job;
+
+// Renders whole units exactly like the sequential loop: every read unit starts a new line.
+static void render_worker(void *ctx, int worker_id, int worker_count) {
+    render_job *job = (render_job *)ctx;
+    size_t first = job->unit_count * (size_t)worker_id / (size_t)worker_count;
+    size_t last = job->unit_count * (size_t)(worker_id + 1) / (size_t)worker_count;
+
+    for (size_t u = first; u < last; u++) {
+        display_state state = *job->base;
+        state.data = job->data + u * MAX_BUFF_SIZE;
+        state.capture = &job->text[u];
+        state.squeeze = job->base->squeeze ? &job->squeeze[u] : NULL;
+        state.addr_display = job->unit_addr[u];
+        state.search_match_index = first_search_match(state.search_results, state.option->search_len, job->unit_addr[u]);
+
+        job->text[u].len = 0;
+        int width = state.option->buff_size;
+        for (size_t processed = 0; processed < job->unit_len[u]; processed += (size_t)width) {
+            int line_len = job->unit_len[u] - processed < (size_t)width ? (int)(job->unit_len[u] - processed) : width;
+            render_line(&state, (int)processed, line_len);
+            state.addr_display += (size_t)line_len;
+        }
+    }
+}
+
+// --jobs: reads a batch of units (the same reads the sequential loop makes), formats them
+// on worker threads and writes the text in address order, so the output is byte-identical.
+static void print_parallel(options *option, FILE *file, display_state *state, output_writer *writer, hole_probe *holes, dump_analysis *analysis, digest_set *digests) {
+    size_t unit_count = (size_t)option->jobs * RENDER_UNITS_PER_JOB;
+
+    render_job job = {0};
+    job.base = state;
+    job.data = malloc(unit_count * MAX_BUFF_SIZE);
+    job.unit_len = calloc(unit_count, sizeof(size_t));
+    job.unit_addr = calloc(unit_count, sizeof(size_t));
+    job.text = calloc(unit_count, sizeof(text_buffer));
+    job.squeeze = calloc(unit_count, sizeof(squeeze_state));
+    if (!job.data || !job.unit_len || !job.unit_addr || !job.text || !job.squeeze) {
+        perror("Malloc failed for render batch");
+        exit(EXIT_FAILURE);
+    }
+    if (state->squeeze) {
+        for (size_t u = 0; u < unit_count; u++) squeeze_init(&job.squeeze[u], option->buff_size);
+    }
+
+    size_t limit = 0;
+    if (option->read_size != 0) limit = option->offset_read + option->read_size;
+    else if (option->limit_read != 0) limit = option->limit_read;
+
+    size_t width = (size_t)option->buff_size;
+    size_t read_start = option->offset_read;
+    bool eof = false;
+
+    while (!eof) {
+        job.unit_count = 0;
+        size_t hole = 0;
+
+        while (job.unit_count < unit_count) {
+            // A hole ends the batch, its row follows the units read so far.
+            hole = hole_at(holes, state->addr_display, limit);
+            if (hole > 0) break;
+
+            int bytes_read = 0;
+            unsigned char *unit = job.data + job.unit_count * MAX_BUFF_SIZE;
+            read_stream_to_buffer(&bytes_read, file, read_start, limit, unit, false);
+            if (bytes_read == 0) {
+                eof = true;
+                break;
             }
 
-            analysis->line_count++;
-            render_line(state, processed, line_len);
-            state->addr_display += (size_t)line_len;
-            processed += line_len;
+            if (needs_analysis(option)) analyse(analysis, unit, (size_t)bytes_read);
+            if (digests->mask) digest_set_update(digests, unit, (size_t)bytes_read);
+            analysis->line_count += ((size_t)bytes_read + width - 1) / width;
+
+            // Runs of repeated lines cross units, so the run state at every unit start
+            // is worked out here, in address order.
+            if (state->squeeze) {
+                squeeze_copy(&job.squeeze[job.unit_count], state->squeeze);
+                squeeze_scan(state->squeeze, option, unit, (size_t)bytes_read);
+            }
+
+            job.unit_len[job.unit_count] = (size_t)bytes_read;
+            job.unit_addr[job.unit_count] = state->addr_display;
+            state->addr_display += (size_t)bytes_read;
+            job.unit_count++;
         }
 
-        pos += chunk;
+        if (job.unit_count == 0 && hole == 0) break;
+
+        int workers = option->jobs;
+        if ((size_t)workers > job.unit_count) workers = (int)job.unit_count;
+        if (workers > 0) run_workers(render_worker, &job, workers);
+
+        for (size_t u = 0; u < job.unit_count; u++) {
+            if (job.text[u].len > 0) writer_write(writer, job.text[u].data, job.text[u].len);
+        }
+
+        // The next read starts behind the hole, read_stream_to_buffer seeks there.
+        if (hole > 0) {
+            skip_hole(option, state, analysis, digests, hole);
+            read_start = state->addr_display;
+        }
+        if (!writer_submit(writer)) break;
     }
 
-    free(decoded.data);
+    for (size_t u = 0; u < unit_count; u++) {
+        free(job.text[u].data);
+        squeeze_free(&job.squeeze[u]);
+    }
+    free(job.squeeze);
+    free(job.text);
+    free(job.unit_addr);
+    free(job.unit_len);
+    free(job.data);
+}
+
+static int compare_ranges(const void *a, const void *b) {
+    const read_range *ra = (const read_range *)a;
+    const read_range *rb = (const read_range *)b;
+    if (ra->offset != rb->offset) return ra->offset < rb->offset ? -1 : 1;
+    if (ra->length != rb->length) return ra->length < rb->length ? -1 : 1;
+    return 0;
+}
+
+// Renders length bytes at offset, read unit by unit. Used for regions too large to merge.
+static bool stream_range(options *option, FILE *file, display_state *state, output_writer *writer, dump_analysis *analysis, digest_set *digests, unsigned char *unit, const read_range *range) {
+    file_seek(file, range->offset);
+
+    for (size_t done = 0; done < range->length;) {
+        size_t want = range->length - done < MAX_BUFF_SIZE ? range->length - done : MAX_BUFF_SIZE;
+        size_t got = fread(unit, 1, want, file);
+        if (got == 0) break;
+
+        render_chunk(option, state, analysis, digests, unit, got);
+        done += got;
+        if (!writer_submit(writer)) return false;
+    }
+    return true;
+}
+
+// --range: the regions are sorted, and neighbours less than RANGE_MERGE_GAP apart are read
+// with one seek and one fread (up to RANGE_SPAN_MAX). Every region is rendered from that
+// buffer under its own sub-header; lines start at the region offset.
+static void print_ranges(options *option, FILE *file, display_state *state, output_writer *writer, dump_analysis *analysis, digest_set *digests) {
+    read_range *ranges = option->ranges;
+    size_t count = option->range_count;
+    qsort(ranges, count, sizeof(read_range), compare_ranges);
+
+    unsigned char *span = malloc(MAX_BUFF_SIZE);
+    size_t span_cap = MAX_BUFF_SIZE;
+    if (!span) {
+        perror("Malloc failed for range buffer");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t first = 0;
+    bool writing = true;
+    while (first < count && writing) {
+        size_t start = ranges[first].offset;
+        size_t end = start + ranges[first].length;
+        size_t last = first + 1;
+
+        while (last < count && ranges[last].offset <= end + RANGE_MERGE_GAP) {
+            size_t range_end = ranges[last].offset + ranges[last].length;
+            size_t group_end = range_end > end ? range_end : end;
+            if (group_end - start > RANGE_SPAN_MAX) break;
+            end = group_end;
+            last++;
+        }
+
+        bool in_memory = end - start <= RANGE_SPAN_MAX;
+        size_t span_len = 0;
+        if (in_memory) {
+            if (end - start > span_cap) {
+                unsigned char *grown = realloc(span, end - start);
+                if (!grown) {
+                    perror("Malloc failed for range buffer");
+                    exit(EXIT_FAILURE);
+                }
+                span = grown;
+                span_cap = end - start;
+            }
+            file_seek(file, start);
+            span_len = fread(span, 1, end - start, file);
+        }
+
+        for (size_t r = first; r < last && writing; r++) {
+            state->addr_display = ranges[r].offset;
+            render_range_header(state, r + 1, count, ranges[r].length);
+
+            if (!in_memory) {
+                writing = stream_range(option, file, state, writer, analysis, digests, span, &ranges[r]);
+                continue;
+            }
+
+            size_t pos = ranges[r].offset - start;
+            size_t range_end = pos + ranges[r].length < span_len ? pos + ranges[r].length : span_len;
+            while (pos < range_end && writing) {
+                size_t chunk = range_end - pos < MAX_BUFF_SIZE ? range_end - pos : MAX_BUFF_SIZE;
+                render_chunk(option, state, analysis, digests, span + pos, chunk);
+                pos += chunk;
+                writing = writer_submit(writer);
+            }
+        }
+
+        first = last;
+    }
+
+    free(span);
 }
 
 // Print the header with file information and current dump settings.
@@ -316,7 +601,7 @@ static void print_header(FILE *out, options *option, int addr_width) {
 
 
 // Print compact footer with analysis and metadata.
-static void print_footer(FILE *out, options *option, int addr_width, const dump_analysis *analysis) {
+static void print_footer(FILE *out, options *option, int addr_width, const dump_analysis *analysis, digest_set *digests) {
     int column_count = _calc_visible_columns(option);
     int row_width = calc_row_width(option, addr_width, column_count);
     file_metadata meta = {0};
@@ -395,6 +680,9 @@ static void print_footer(FILE *out, options *option, int addr_width, const dump_
             option->color ? ANALYSIS_TEXT_COLOR : "",
             magic_line);
     }
+
+    // digests of the dumped range (--hash)
+    if (digests->mask) print_digest_rows(out, option, digests);
     
     // view options
     if (option->color) fprintf(out, "%s", HEADER_COLOR);
@@ -408,7 +696,8 @@ static void print_footer(FILE *out, options *option, int addr_width, const dump_
             option->offset_read,
             analysis->line_count);
 
-    if (option->read_size != 0) fprintf(out, "read %zu", option->read_size);
+    if (option->range_count > 0) fprintf(out, "ranges %zu", option->range_count);
+    else if (option->read_size != 0) fprintf(out, "read %zu", option->read_size);
     else if (option->limit_read == total_size) fprintf(out, "limit eof");
     else if (option->limit_read != 0) fprintf(out, "limit %zu", option->limit_read);
 
@@ -430,18 +719,35 @@ static void print_footer(FILE *out, options *option, int addr_width, const dump_
 }
 
 // Main function to print the hex dump based on the provided options
+// Stops a running search once the reader of the sink is gone.
+static bool search_stop(void *ctx) {
+    return sink_reader_closed(ctx);
+}
+
 void print_output(options *option) {
-    // Open pager if requested, otherwise use stdout
-    FILE *out = stdout;
-    unsigned char *display_buffer = get_display_buffer();
+    // Dump goes to stdout or the pager (see Sink.c), header and footer to its stream.
+    output_sink sink;
+    sink_stdout(&sink);
+    FILE *out = sink.stream;
+    unsigned char *display_buffer = malloc(MAX_BUFF_SIZE);
     SearchResults *search_results = NULL;
 
+    if (!display_buffer) {
+        perror("Malloc failed for display buffer");
+        exit(EXIT_FAILURE);
+    }
+
     bool no_newline = false;
     if (option->buff_size == 0) {
         no_newline = true;
         option->buff_size = 1024;
     }
 
+    // --tail on stdin: the stream is read to its end first, only the tail is kept.
+    if (option->pipeline && option->tail_size != 0 && !option->reverse_mode) {
+        option->offset_read = stdin_keep_tail(option->tail_size, option->limit_read);
+    }
+
     if (option->search_len > 0 && option->pipeline) {
         fprintf(stderr, "Search is currently only supported for files, not stdin\n");
         exit(EXIT_FAILURE);
@@ -457,9 +763,12 @@ void print_output(options *option) {
 
     display_state state = {0};
     dump_analysis analysis = {0};
+    digest_set digests;
+    digest_set_init(&digests, option->hash_mask);
     state.out = out;
     state.option = option;
     state.search_results = NULL;
+    state.data = display_buffer;
     state.addr_display = option->offset_read;
     state.search_match_index = 0;
     state.addr_width = 8;
@@ -477,23 +786,35 @@ void print_output(options *option) {
 
     FILE *file = open_input_file(option);
 
+    // The pager opens before the search, so quitting it also ends a long search.
+    if (option->pager) {
+        sink_open_pager(&sink);
+        out = sink.stream;
+        state.out = out;
+    }
+
     if (option->search_len > 0) {
-        search_results = search_matches(option, file);
+        search_results = search_matches(option, file, search_stop, &sink);
         state.search_results = search_results;
+
+        if (sink_reader_closed(&sink)) {
+            fclose(file);
+            sink_close(&sink);
+            free_search_results(search_results);
+            free(display_buffer);
+            exit(EXIT_SUCCESS);
+        }
     }
 
     if (option->search_len != 0 &&state.search_results->count == 0) {
-        if(option->color && option->search_len > 0) fprintf(stderr, "\n%sNo matches found for search string%s\n", ERROR_COLOR, RESET);
+        if (sink.kind == SINK_PAGER) fprintf(out, "No matches found for search string\n");
+        else if(option->color && option->search_len > 0) fprintf(stderr, "\n%sNo matches found for search string%s\n", ERROR_COLOR, RESET);
         else printf("No matches found for search string\n");
+        sink_close(&sink);
         free(search_results);
         exit(EXIT_SUCCESS);
     }
 
-    if (option->pager) {
-        out = open_pager();
-        state.out = out;
-    }
-
     // Search for magic byte signatures in the file header when dumping binary input.
     if (!option->skip_header && !option->reverse_mode) find_magic_bytes_in_stream_header(file);
     
@@ -503,9 +824,30 @@ void print_output(options *option) {
     int bytes_read = 0; // Bytes read in last read_file_to_buffer call.
     analysis.magic_count = count_found_magic();
 
+    // --squeeze compares against the previous line; with -se only matching lines are shown anyway.
+    squeeze_state squeeze = {0};
+    if (option->squeeze && option->search_len == 0) {
+        squeeze_init(&squeeze, option->buff_size);
+        state.squeeze = &squeeze;
+    }
+
+    // Sparse files: holes in the range are skipped without reading them.
+    hole_probe holes;
+    hole_probe_open(&holes, skips_holes(option) ? option->filename : NULL);
+
+    // Lines are rendered into the writer's buffer, the header above is already in out.
+    output_writer *writer = writer_open(&sink);
+    state.capture = writer_buffer(writer);
+
     if (option->reverse_mode) {
-        print_reverse(option, file, &state, &analysis);
+        print_reverse(option, file, &state, writer, &analysis, &digests);
+    } else if (option->range_count > 0) {
+        print_ranges(option, file, &state, writer, &analysis, &digests);
+    } else if (option->jobs > 1) {
+        print_parallel(option, file, &state, writer, &holes, &analysis, &digests);
     } else {
+        size_t read_start = option->offset_read;
+
         // --- Output Loop ---
         while (1) {
             size_t limit = 0;
@@ -513,13 +855,23 @@ void print_output(options *option) {
             if (option->read_size != 0) limit = option->offset_read + option->read_size;
             else if (option->limit_read != 0) limit = option->limit_read;
 
-            read_stream_to_buffer(&bytes_read, file, option->offset_read, limit, display_buffer, false);
+            // Holes of sparse files become one row, the next read seeks behind them.
+            size_t hole = hole_at(&holes, state.addr_display, limit);
+            if (hole > 0) {
+                skip_hole(option, &state, &analysis, &digests, hole);
+                read_start = state.addr_display;
+                if (!writer_submit(writer)) break;
+                continue;
+            }
+
+            read_stream_to_buffer(&bytes_read, file, read_start, limit, display_buffer, false);
             if (bytes_read == 0) break;
 
             int processed = 0;
 
-            // Init Analysis for this chunk
-            analyse(&analysis, display_buffer, (size_t)bytes_read);
+            // Init Analysis for this chunk (only the footer consumes it)
+            if (needs_analysis(option)) analyse(&analysis, display_buffer, (size_t)bytes_read);
+            if (digests.mask) digest_set_update(&digests, display_buffer, (size_t)bytes_read);
 
             // Process the buffer in lines of buff_size, ensuring we don't exceed bytes_read.
             while (processed < bytes_read) {
@@ -535,14 +887,37 @@ void print_output(options *option) {
                 state.addr_display += (size_t)line_len;
                 processed += line_len;
             }
+
+            if (!writer_submit(writer)) break;
         }
     }
 
-    if (!option->raw && !option->skip_header) print_footer(out, option, state.addr_width, &analysis);
+    // A run of repeats at the end of the range still gets its * row.
+    flush_squeeze(&state);
+    squeeze_free(&squeeze);
+    hole_probe_close(&holes);
+
+    // Flushes the lines rendered so far, even when a write failed on the way.
+    int write_error = writer_close(writer);
+    if (write_error) {
+        if (!option->pipeline) fclose(file);
+        sink_close(&sink);
+        free_search_results(search_results);
+        free(display_buffer);
+        exit(sink_exit_status(write_error));
+    }
+
+    if (!option->raw && !option->skip_header) print_footer(out, option, state.addr_width, &analysis, &digests);
     if (!option->raw && !option->skip_header) fprintf(out, "\n");
 
+    // Without a footer the digests go to stderr, so raw output stays byte exact.
+    if (digests.mask && (option->raw || option->skip_header)) print_digest_lines(stderr, option, &digests);
+
     // Closes the file handle opened at the beginning of print_output.
     if (!option->pipeline) fclose(file);
-    if (option->pager) pclose(out);
+    write_error = sink_close(&sink);
     free_search_results(search_results);
+    free(display_buffer);
+
+    if (write_error) exit(sink_exit_status(write_error));
 }
@@ -14,32 +14,22 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "Analysis.h"
 #include "File.h"
 #include "MagicBytes.h"
 #include "Utils.h"
 
-static unsigned char buffer[MAX_BUFF_SIZE] = {0};       // Shared buffer for reading file chunks and rendering lines.
-static int found_magic_arr[256] = {0};                  // Array to track which magic byte signatures have been found in the file header.
-
 // Calculates the Shannon entropy of a given data buffer, which can 
 // be used to determine the randomness of the data in that buffer.
 static inline float calc_entropy(const unsigned char *data, size_t len) {
     if (len == 0) return 0.0f;
 
-    size_t freq[256] = {0};
+    uint64_t freq[256] = {0};
     for (size_t i = 0; i < len; i++) {
         freq[data[i]]++;
     }
 
-    float entropy = 0.0f;
-    for (int i = 0; i < 256; i++) {
-        if (freq[i] > 0) {
-            float p = (float)freq[i] / (float)len;
-            entropy -= p * log2f(p);
-        }
-    }
-
-    return entropy;
+    return entropy_from_counts(freq, (uint64_t)len);
 }
 
 // Determines how many characters to use for each byte based on the selected output mode.
@@ -196,11 +186,11 @@ static void append_hex_section(char *line, size_t *line_pos, const display_state
     int column_count = get_render_column_count(state);
 
     unsigned char max, min;
-    find_extrema(&max, &min, buffer + processed, (size_t)line_len);
+    find_extrema(&max, &min, state->data + processed, (size_t)line_len);
 
     for (int i = 0; i < column_count; i++) {
         if (i < line_len) {
-            unsigned char b = buffer[processed + i];
+            unsigned char b = state->data[processed + i];
             const char *col = resolve_byte_color(&b, state, max, min);
             bool highlight = state->option->color &&
                              byte_is_highlighted(state, state->addr_display + (size_t)i);
@@ -225,11 +215,11 @@ static void append_octal_section(char *line, size_t *line_pos, const display_sta
     int column_count = get_render_column_count(state);
 
     unsigned char max, min;
-    find_extrema(&max, &min, buffer + processed, (size_t)line_len);
+    find_extrema(&max, &min, state->data + processed, (size_t)line_len);
 
     for (int i = 0; i < column_count; i++) {
         if (i < line_len) {
-            unsigned char b = buffer[processed + i];
+            unsigned char b = state->data[processed + i];
             const char *col = resolve_byte_color(&b, state, max, min);
             bool highlight = state->option->color &&
                              byte_is_highlighted(state, state->addr_display + (size_t)i);
@@ -254,11 +244,11 @@ static void append_binary_section(char *line, size_t *line_pos, const display_st
     int column_count = get_render_column_count(state);
 
     unsigned char max, min;
-    find_extrema(&max, &min, buffer + processed, (size_t)line_len);
+    find_extrema(&max, &min, state->data + processed, (size_t)line_len);
 
     for (int i = 0; i < column_count; i++) {
         if (i < line_len) {
-            unsigned char b = buffer[processed + i];
+            unsigned char b = state->data[processed + i];
             const char *col = resolve_byte_color(&b, state, max, min);
             bool highlight = state->option->color &&
                              byte_is_highlighted(state, state->addr_display + (size_t)i);
@@ -283,11 +273,11 @@ static void append_decimal_section(char *line, size_t *line_pos, const display_s
     int column_count = get_render_column_count(state);
 
     unsigned char max, min;
-    find_extrema(&max, &min, buffer + processed, (size_t)line_len);
+    find_extrema(&max, &min, state->data + processed, (size_t)line_len);
 
     for (int i = 0; i < column_count; i++) {
         if (i < line_len) {
-            unsigned char b = buffer[processed + i];
+            unsigned char b = state->data[processed + i];
             const char *col = resolve_byte_color(&b, state, max, min);
             bool highlight = state->option->color &&
                              byte_is_highlighted(state, state->addr_display + (size_t)i);
@@ -311,14 +301,14 @@ static void append_decimal_section(char *line, size_t *line_pos, const display_s
 static int append_ascii_section(char *line, size_t *line_pos, const display_state *state, int processed, int line_len) {
     int char_written = 0;
     unsigned char max, min;
-    find_extrema(&max, &min, buffer + processed, (size_t)line_len);
+    find_extrema(&max, &min, state->data + processed, (size_t)line_len);
 
     if (state->option->ascii) {
         char *c = (state->option->color) ? BORDER_COLOR : "";
         append_to_line(line, MAX_LINE_SIZE, line_pos, "%s| ", c);
 
         for (int i = 0; i < line_len; i++) {
-            unsigned char c = buffer[processed + i];
+            unsigned char c = state->data[processed + i];
             const char *col = resolve_byte_color(&c, state, max, min);
             char disp = (c >= 32 && c < 127) ? (char)c : '.';
             bool highlight = state->option->color &&
@@ -344,13 +334,9 @@ static int append_ascii_section(char *line, size_t *line_pos, const display_stat
 static void append_entropy_bar(char *line, size_t *line_pos, const display_state *state,
                                int processed, int line_len, int char_written, const options *option) {
     if (state->option->entropie) {
-        float entropy = calc_entropy(buffer + processed, (size_t)line_len);
+        float entropy = calc_entropy(state->data + processed, (size_t)line_len);
 
-        const char *bar;
-        if (entropy < 2.0f) bar = "░";
-        else if (entropy < 4.0f) bar = "▒";
-        else if (entropy < 6.0f) bar = "▓";
-        else bar = "█";
+        const char *bar = entropy_bar_glyph(entropy);
 
         const char *col = heatmap_colors[INDEX_MAP(entropy, 0.0f, 8.0f)];
         int space_for_bar = !option->ascii ? 1 : get_render_column_count(state) - char_written + 1;
@@ -426,18 +412,6 @@ int calc_row_width(const options *option, int addr_width, int column_count) {
     return width;
 }
 
-// Counts how many magic byte signatures have been found in the file header, 
-// which can be used to display a summary of detected file types.
-int count_found_magic(void) {
-    int found_count = 0;
-
-    for (int sig_id = 0; sig_id < Magic_Signatures_Count; sig_id++) {
-        if (found_magic_arr[sig_id] == 1) found_count++;
-    }
-
-    return found_count;
-}
-
 // Appends a summary of found magic byte signatures to the output line, showing the description and 
 // offset of each detected signature, and indicating if there are more signatures than can be displayed.
 void append_magic_summary(char *buffer_out, size_t buffer_size, size_t *pos) {
@@ -445,7 +419,7 @@ void append_magic_summary(char *buffer_out, size_t buffer_size, size_t *pos) {
     int found_count = count_found_magic();
 
     for (int sig_id = 0; sig_id < Magic_Signatures_Count; sig_id++) {
-        if (found_magic_arr[sig_id] != 1) continue;
+        if (!magic_found(sig_id)) continue;
 
         const MagicSignature *sig = &Magic_Signatures[sig_id];
         if (printed > 0) append_to_line(buffer_out, buffer_size, pos, " | ");
@@ -460,40 +434,29 @@ void append_magic_summary(char *buffer_out, size_t buffer_size, size_t *pos) {
     }
 }
 
-// Reads the first part of the file and checks for known magic byte signatures in the header,
-// updating the found_magic_arr to indicate which signatures were detected.
-void find_magic_bytes_in_stream_header(FILE *file) {
-    if (file == NULL || file == stdin) return;
-
-    fseek(file, 0, SEEK_END);
-    size_t file_size = (size_t)ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    if (file_size == 0) return;
-
-    enum { READ_PREFIX_SIZE = 65536 };
-    size_t to_read = (file_size < READ_PREFIX_SIZE) ? file_size : READ_PREFIX_SIZE;
-    unsigned char *magic_buffer = malloc(to_read);
-    if (!magic_buffer) {
-        perror("Malloc failed for file header");
-        exit(EXIT_FAILURE);
-    }
-
-    size_t bytes_read = fread(magic_buffer, 1, to_read, file);
+// Prints one "label    | text" row in the same layout as the dump footer,
+// used by the report modes that print analysis results without a hex dump.
+void print_report_row(FILE *out, const options *option, const char *label, const char *fmt, ...) {
+    char text[MAX_LINE_SIZE] = {0};
 
-    for (int sig_id = 0; sig_id < Magic_Signatures_Count; sig_id++) {
-        const MagicSignature *sig = &Magic_Signatures[sig_id];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
 
-        if (sig->offset + sig->len > file_size || sig->offset + sig->len > bytes_read) {
-            continue;
-        }
+    int pad = 9 - (int)strlen(label);
+    if (pad < 1) pad = 1;
 
-        if (memcmp(magic_buffer + sig->offset, sig->bytes, sig->len) == 0) {
-            found_magic_arr[sig_id] = 1;
-        }
-    }
+    if (option->color) fprintf(out, "%s", HEADER_COLOR);
+    fprintf(out, "%s", label);
 
-    free(magic_buffer);
+    if (option->color) fprintf(out, "%s", RESET);
+    fprintf(out, "%s%*s|%s %s%s\n",
+            option->color ? BORDER_COLOR : "",
+            pad, "",
+            option->color ? ANALYSIS_TEXT_COLOR : "",
+            text,
+            option->color ? RESET : "");
 }
 
 // Opens the input file based on the options, returning a FILE pointer to either the specified file or stdin if no file is provided.
@@ -543,27 +506,176 @@ void append_header_columns(char *line, size_t line_size, size_t *line_pos, const
     }
 }
 
+static bool line_is_zero(const unsigned char *data, int len) {
+    for (int i = 0; i < len; i++) {
+        if (data[i] != 0) return false;
+    }
+    return true;
+}
+
+// Compares two lines 16 bytes at a time, the tail (or everything without SSE2) bytewise.
+static bool lines_equal(const unsigned char *a, const unsigned char *b, size_t len) {
+    size_t i = 0;
+
+    #ifdef HXED_HAVE_SSE2
+    for (; i + 16 <= len; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xFFFF) return false;
+    }
+    #endif
+
+    for (; i < len; i++) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+// Counts the line into the current run when it repeats the previous line. Otherwise the
+// line becomes the new reference and false is returned; the pending run is left for the
+// caller to print. Lines of different length (the last one of a read) never repeat.
+static bool squeeze_repeat(squeeze_state *squeeze, const unsigned char *line, int len) {
+    if (len == squeeze->prev_len && lines_equal(line, squeeze->prev, (size_t)len)) {
+        squeeze->lines++;
+        squeeze->bytes += (size_t)len;
+        return true;
+    }
+
+    memcpy(squeeze->prev, line, (size_t)len);
+    squeeze->prev_len = len;
+    return false;
+}
+
+void squeeze_init(squeeze_state *squeeze, int width) {
+    squeeze->prev = malloc((size_t)width);
+    if (!squeeze->prev) {
+        perror("Malloc failed for squeeze line");
+        exit(EXIT_FAILURE);
+    }
+    squeeze->prev_len = -1;
+    squeeze->lines = 0;
+    squeeze->bytes = 0;
+}
+
+// dst must be initialized with the same width as src.
+void squeeze_copy(squeeze_state *dst, const squeeze_state *src) {
+    if (src->prev_len > 0) memcpy(dst->prev, src->prev, (size_t)src->prev_len);
+    dst->prev_len = src->prev_len;
+    dst->lines = src->lines;
+    dst->bytes = src->bytes;
+}
+
+void squeeze_free(squeeze_state *squeeze) {
+    free(squeeze->prev);
+    squeeze->prev = NULL;
+}
+
+// Advances the squeeze state over a chunk exactly like rendering it would, without
+// rendering. The --jobs renderer uses it to hand every worker the state at its chunk.
+void squeeze_scan(squeeze_state *squeeze, const options *option, const unsigned char *data, size_t len) {
+    size_t width = (size_t)option->buff_size;
+
+    for (size_t pos = 0; pos < len; pos += width) {
+        int line_len = len - pos < width ? (int)(len - pos) : (int)width;
+        if (option->skip_zero && line_is_zero(data + pos, line_len)) continue;
+        if (!squeeze_repeat(squeeze, data + pos, line_len)) {
+            squeeze->lines = 0;
+            squeeze->bytes = 0;
+        }
+    }
+}
+
+// Prints the * row of a pending run of repeated lines (xxd -a / hexdump style) and
+// starts a new run. The next printed address shows where the run ended.
+void flush_squeeze(display_state *state) {
+    squeeze_state *squeeze = state->squeeze;
+    if (!squeeze || squeeze->lines == 0) return;
+
+    char line[MAX_LINE_SIZE];
+    size_t line_pos = 0;
+    const options *option = state->option;
+
+    if (option->raw) {
+        append_to_line(line, sizeof(line), &line_pos, "*\n");
+    } else {
+        append_to_line(line, sizeof(line), &line_pos, "%s%-*s %s| %s%zu repeated lines (%zu B)%s\n",
+                       option->color ? ADDR_COLOR : "", state->addr_width, "*",
+                       option->color ? BORDER_COLOR : "",
+                       option->color ? ANALYSIS_TEXT_COLOR : "",
+                       squeeze->lines, squeeze->bytes,
+                       option->color ? RESET : "");
+    }
+
+    if (state->capture) text_buffer_append(state->capture, line, line_pos);
+    else fwrite(line, 1, line_pos, state->out);
+
+    squeeze->lines = 0;
+    squeeze->bytes = 0;
+}
+
+// Prints one row for a hole of a sparse file that is skipped without reading it. A pending
+// run of repeats ends before the hole, and the first line behind it is always printed.
+void render_hole(display_state *state, size_t len) {
+    flush_squeeze(state);
+    if (state->squeeze) state->squeeze->prev_len = -1;
+
+    char line[MAX_LINE_SIZE];
+    size_t line_pos = 0;
+    const options *option = state->option;
+
+    append_line_prefix(line, &line_pos, state);
+    append_to_line(line, sizeof(line), &line_pos, "%shole, %zu zero bytes not stored on disk%s\n",
+                   option->color ? ANALYSIS_TEXT_COLOR : "", len,
+                   option->color ? RESET : "");
+
+    if (state->capture) text_buffer_append(state->capture, line, line_pos);
+    else fwrite(line, 1, line_pos, state->out);
+}
+
+// Sub-header above region index (1-based) of count in a --range dump, for the range of
+// length bytes at state->addr_display. Repeats never run from one region into the next.
+void render_range_header(display_state *state, size_t index, size_t count, size_t length) {
+    flush_squeeze(state);
+    if (state->squeeze) state->squeeze->prev_len = -1;
+
+    const options *option = state->option;
+    if (option->raw) return;
+
+    char label[32];
+    snprintf(label, sizeof(label), "range %zu", index);
+
+    char line[MAX_LINE_SIZE];
+    size_t line_pos = 0;
+    append_to_line(line, sizeof(line), &line_pos, "%s%-*s %s| %s%zu B at %0*zX (%zu of %zu)%s\n",
+                   option->color ? HEADER_COLOR : "", state->addr_width, label,
+                   option->color ? BORDER_COLOR : "",
+                   option->color ? ANALYSIS_TEXT_COLOR : "",
+                   length, state->addr_width, state->addr_display, index, count,
+                   option->color ? RESET : "");
+
+    if (state->capture) text_buffer_append(state->capture, line, line_pos);
+    else fwrite(line, 1, line_pos, state->out);
+}
+
 // Renders a single line of output based on the current display state, including the address offset, 
 // hex/octal/decimal columns, ASCII representation, and entropy bar, while applying coloring and spacing based on options.
 void render_line(display_state *state, int processed, int line_len) {
-    char line[MAX_LINE_SIZE] = {0};
-    size_t line_pos = 0;
-
     if (!line_has_search_match(state, state->addr_display, line_len)) {
         return;
     }
 
-    if (state->option->skip_zero) {
-        bool all_zero = true;
-        for (int i = 0; i < line_len; i++) {
-            if (buffer[processed + i] != 0) {
-                all_zero = false;
-                break;
-            }
-        }
-        if (all_zero) return;
+    if (state->option->skip_zero && line_is_zero(state->data + processed, line_len)) return;
+
+    // A repeat only extends the run, the first different line prints the * row before itself.
+    if (state->squeeze) {
+        if (squeeze_repeat(state->squeeze, state->data + processed, line_len)) return;
+        flush_squeeze(state);
     }
 
+    // Declared after the early returns: zeroing the line buffer costs more than a skipped line.
+    char line[MAX_LINE_SIZE] = {0};
+    size_t line_pos = 0;
+
     append_line_prefix(line, &line_pos, state);
 
     switch (state->option->output_mode) {
@@ -588,7 +700,8 @@ void render_line(display_state *state, int processed, int line_len) {
     if (!state->no_newline) append_to_line(line, MAX_LINE_SIZE, &line_pos, "\x1b[0m\n");
 
     if (!is_space((size_t)state->option->buff_size, (unsigned char *)line)) {
-        fwrite(line, 1, line_pos, state->out);
+        if (state->capture) text_buffer_append(state->capture, line, line_pos);
+        else fwrite(line, 1, line_pos, state->out);
     }
 }
 
@@ -605,17 +718,134 @@ int _hex_digits_size_t(size_t value) {
     return digits;
 }
 
-// Resets the internal state of the display utilities, clearing buffers and resetting flags, 
-// which can be useful when processing multiple files or streams in a single run.
+// Maps an entropy value (0-8 bits/byte) to the shade glyph used by the entropy bar and map.
+const char *entropy_bar_glyph(float entropy) {
+    if (entropy < 2.0f) return "░";
+    if (entropy < 4.0f) return "▒";
+    if (entropy < 6.0f) return "▓";
+    return "█";
+}
+
+// Visible width of one side of a comparison line (hex cells, group spacing, ASCII column).
+int compare_side_width(const options *option) {
+    int width = option->buff_size * 2;
+
+    if (option->grouping != 0) {
+        width += option->buff_size;
+        if (option->grouping > 1) width += (option->buff_size - 1) / option->grouping;
+    }
+
+    if (option->ascii) width += option->buff_size + 3;
+    return width;
+}
+
+// Appends one side of a comparison line (hex cells and optional ASCII column). Bytes
+// that differ from the other side, or have no counterpart, are highlighted. Cells
+// before first stay blank (continuation of a line that was printed partially).
+void append_compare_side(char *line, size_t *line_pos, const options *option, size_t first,
+                         const unsigned char *self, size_t len,
+                         const unsigned char *other, size_t other_len) {
+    int columns = option->buff_size;
+
+    for (int i = 0; i < columns; i++) {
+        if ((size_t)i >= first && (size_t)i < len) {
+            bool changed = (size_t)i >= other_len || self[i] != other[i];
+            if (changed && option->color) {
+                append_to_line(line, MAX_LINE_SIZE, line_pos, "%s%02x%s", HIGHLIGHT_COLOR, self[i], RESET);
+            } else {
+                append_to_line(line, MAX_LINE_SIZE, line_pos, "%02x", self[i]);
+            }
+        } else {
+            append_to_line(line, MAX_LINE_SIZE, line_pos, "  ");
+        }
+
+        if (option->grouping != 0) {
+            append_to_line(line, MAX_LINE_SIZE, line_pos, " ");
+            if (option->grouping > 1 && (i + 1) % option->grouping == 0 && i != columns - 1) {
+                append_to_line(line, MAX_LINE_SIZE, line_pos, " ");
+            }
+        }
+    }
+
+    if (!option->ascii) return;
+
+    append_to_line(line, MAX_LINE_SIZE, line_pos, "%s| %s", option->color ? BORDER_COLOR : "", option->color ? RESET : "");
+    for (int i = 0; i < columns; i++) {
+        if ((size_t)i < first || (size_t)i >= len) {
+            append_to_line(line, MAX_LINE_SIZE, line_pos, " ");
+            continue;
+        }
+
+        char disp = (self[i] >= 32 && self[i] < 127) ? (char)self[i] : '.';
+        bool changed = (size_t)i >= other_len || self[i] != other[i];
+        if (changed && option->color) {
+            append_to_line(line, MAX_LINE_SIZE, line_pos, "%s%c%s", HIGHLIGHT_COLOR, disp, RESET);
+        } else {
+            append_to_line(line, MAX_LINE_SIZE, line_pos, "%c", disp);
+        }
+    }
+    append_to_line(line, MAX_LINE_SIZE, line_pos, " ");
+}
+
+// One footer row per --hash algorithm, in a fixed order.
+void print_digest_rows(FILE *out, const options *option, digest_set *digests) {
+    char hex[72];
+
+    for (unsigned int algorithm = HASH_CRC32; algorithm <= HASH_SHA256; algorithm <<= 1) {
+        if (!(digests->mask & algorithm)) continue;
+        digest_set_format(digests, algorithm, hex, sizeof(hex));
+        print_report_row(out, option, hash_name(algorithm), "%s", hex);
+    }
+}
+
+// Checksum-tool style lines ("<digest>  <name>  <file>") for output without a footer.
+void print_digest_lines(FILE *out, const options *option, digest_set *digests) {
+    char hex[72];
+
+    for (unsigned int algorithm = HASH_CRC32; algorithm <= HASH_SHA256; algorithm <<= 1) {
+        if (!(digests->mask & algorithm)) continue;
+        digest_set_format(digests, algorithm, hex, sizeof(hex));
+        fprintf(out, "%s  %s  %s\n", hex, hash_name(algorithm), option->pipeline ? "-" : option->filename);
+    }
+}
+
+// Resets the per-run state (detected magic signatures), which can be useful
+// when processing multiple files or streams in a single run.
 void reset_display_utils_state(void) {
-    memset(buffer, 0, sizeof(buffer));
-    memset(found_magic_arr, 0, sizeof(found_magic_arr));
+    reset_found_magic();
 }
 
-// Provides access to the shared buffer used for reading file chunks and rendering lines, 
-// allowing other parts of the program to read from or write to this buffer as needed.
-unsigned char *get_display_buffer(void) {
-    return buffer;
+// Appends len bytes to a text buffer, growing it as needed.
+void text_buffer_append(text_buffer *buf, const char *data, size_t len) {
+    if (buf->len + len > buf->cap) {
+        size_t cap = buf->cap ? buf->cap : 4096;
+        while (cap < buf->len + len) cap *= 2;
+
+        char *grown = realloc(buf->data, cap);
+        if (!grown) {
+            perror("Malloc failed for output buffer");
+            exit(EXIT_FAILURE);
+        }
+        buf->data = grown;
+        buf->cap = cap;
+    }
+
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+}
+
+// Index of the first search match that ends after addr. A render state that starts at addr
+// with this index behaves exactly like one that rendered every line before it.
+size_t first_search_match(const SearchResults *results, size_t search_len, size_t addr) {
+    if (!results) return 0;
+
+    size_t lo = 0, hi = results->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (results->matches[mid].addr + search_len > addr) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
 }
 
 static void show_progress(const char *label, size_t current, size_t total, const options *option) {
@@ -644,7 +874,7 @@ static void show_progress(const char *label, size_t current, size_t total, const
 
 }
 
-SearchResults *search_matches(const options *option, FILE *file) {
+SearchResults *search_matches(const options *option, FILE *file, search_stop_fn stop, void *stop_ctx) {
     if (!file || !option->search || option->search_len == 0) {
         return NULL;
     }
@@ -718,6 +948,9 @@ SearchResults *search_matches(const options *option, FILE *file) {
     size_t total_bytes = search_limit - search_start;
 
     while (search_start + total_read < search_limit) {
+        // Nobody reads the output anymore (pager quit, pipe closed).
+        if (stop && stop(stop_ctx)) break;
+
         size_t remaining = search_limit - (search_start + total_read);
         size_t to_read = remaining < chunk_size ? remaining : chunk_size;
         size_t read_bytes = fread(read_buf, 1, to_read, file);
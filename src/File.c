@@ -5,19 +5,206 @@
  * See LICENSE file in the project root for full license information.
  */
 
+// glibc only declares SEEK_DATA and SEEK_HOLE for GNU sources.
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <errno.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "File.h"
 
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 #define MAX_BUFF_SIZE 16384
 
+// Ring buffer in front of standard input. A pipe returns whatever the writer flushed, so
+// one read can be a few bytes; the ring collects big reads and hands out full units, which
+// keeps every line of the dump aligned to the width. Reads never go past the range end.
+typedef struct {
+    unsigned char *data;
+    size_t size;        // Capacity of data
+    size_t head;        // Next byte handed out
+    size_t len;         // Buffered bytes from head on
+    size_t pos;         // Stream position of head
+    bool eof;
+    bool started;       // The offset was skipped
+} stdin_ring;
+
+static stdin_ring stdin_reader;
+
+// One read from standard input, retried on EINTR. 0 = end of input or error.
+static size_t read_stdin(unsigned char *buf, size_t len) {
+    #ifdef _WIN32
+    return fread(buf, 1, len, stdin);
+    #else
+    while (1) {
+        ssize_t got = read(STDIN_FILENO, buf, len);
+        if (got >= 0) return (size_t)got;
+        if (errno != EINTR) return 0;
+    }
+    #endif
+}
+
+// Reads into the free space behind the buffered bytes with a single call.
+static void stdin_fill(stdin_ring *ring, size_t limit) {
+    if (ring->len == 0) ring->head = 0;
+
+    size_t tail = (ring->head + ring->len) % ring->size;
+    size_t space = tail >= ring->head ? ring->size - tail : ring->head - tail;
+    if (ring->len == ring->size) space = 0;
+
+    // -r/-l: stop reading exactly at the end of the range.
+    if (limit != 0) {
+        size_t buffered_end = ring->pos + ring->len;
+        size_t remaining = limit > buffered_end ? limit - buffered_end : 0;
+        if (remaining < space) space = remaining;
+    }
+
+    // The range is complete, nothing more is read.
+    if (space == 0) {
+        ring->eof = true;
+        return;
+    }
+
+    size_t got = read_stdin(ring->data + tail, space);
+    if (got == 0) ring->eof = true;
+    ring->len += got;
+}
+
+// Drops count bytes for -o. Redirected files are seeked and pipes are spliced into
+// /dev/null inside the kernel; anything else is read into the ring and thrown away.
+static void stdin_discard(stdin_ring *ring, size_t count) {
+    size_t done = 0;
+
+    #ifndef _WIN32
+    if (lseek(STDIN_FILENO, (off_t)count, SEEK_CUR) >= 0) {
+        ring->pos += count;
+        return;
+    }
+    #endif
+
+    #ifdef __linux__
+    int null_fd = open("/dev/null", O_WRONLY);
+    while (null_fd >= 0 && done < count) {
+        ssize_t moved = splice(STDIN_FILENO, NULL, null_fd, NULL, count - done, 0);
+        if (moved < 0 && errno == EINTR) continue;
+        if (moved == 0) ring->eof = true;
+        if (moved <= 0) break;
+        done += (size_t)moved;
+    }
+    if (null_fd >= 0) close(null_fd);
+    #endif
+
+    while (done < count && !ring->eof) {
+        size_t part = count - done < ring->size ? count - done : ring->size;
+        size_t got = read_stdin(ring->data, part);
+        if (got == 0) ring->eof = true;
+        done += got;
+    }
+    ring->pos += done;
+}
+
+static void stdin_alloc(stdin_ring *ring, size_t size) {
+    ring->data = malloc(size);
+    if (!ring->data) {
+        perror("Malloc failed for stdin buffer");
+        exit(EXIT_FAILURE);
+    }
+    ring->size = size;
+}
+
+// --tail on standard input: reads the stream up to its end (or read_limit) and keeps only
+// the last keep bytes, overwriting older data in the ring, so memory stays bounded by the
+// tail. Returns the stream position of the first kept byte; stdin_read hands them out.
+size_t stdin_keep_tail(size_t keep, size_t read_limit) {
+    stdin_ring *ring = &stdin_reader;
+
+    // Small tails still get a full size ring, so the stream is read in large calls.
+    stdin_alloc(ring, keep > STDIN_RING_SIZE ? keep : STDIN_RING_SIZE);
+    ring->started = true;
+
+    while (1) {
+        size_t tail = (ring->head + ring->len) % ring->size;
+        size_t space = ring->size - tail;
+        if (read_limit != 0) {
+            size_t buffered_end = ring->pos + ring->len;
+            size_t remaining = read_limit > buffered_end ? read_limit - buffered_end : 0;
+            if (remaining < space) space = remaining;
+        }
+        if (space == 0) break;
+
+        size_t got = read_stdin(ring->data + tail, space);
+        if (got == 0) break;
+        ring->len += got;
+
+        // A full ring drops its oldest bytes.
+        if (ring->len > ring->size) {
+            size_t drop = ring->len - ring->size;
+            ring->head = (ring->head + drop) % ring->size;
+            ring->len = ring->size;
+            ring->pos += drop;
+        }
+    }
+
+    if (ring->len > keep) {
+        size_t drop = ring->len - keep;
+        ring->head = (ring->head + drop) % ring->size;
+        ring->len = keep;
+        ring->pos += drop;
+    }
+
+    ring->eof = true;
+    return ring->pos;
+}
+
+// Hands out the next unit of [read_start, read_limit) of standard input. The unit is only
+// short at the end of the input or of the range.
+static size_t stdin_read(unsigned char *buf, size_t read_start, size_t read_limit) {
+    stdin_ring *ring = &stdin_reader;
+
+    if (!ring->data) stdin_alloc(ring, STDIN_RING_SIZE);
+
+    if (!ring->started) {
+        ring->started = true;
+        if (read_start > 0) stdin_discard(ring, read_start);
+    }
+
+    size_t want = MAX_BUFF_SIZE;
+    if (read_limit != 0) {
+        size_t remaining = read_limit > ring->pos ? read_limit - ring->pos : 0;
+        if (remaining < want) want = remaining;
+    }
+
+    while (ring->len < want && !ring->eof) stdin_fill(ring, read_limit);
+
+    size_t n = ring->len < want ? ring->len : want;
+    size_t first = ring->size - ring->head < n ? ring->size - ring->head : n;
+    memcpy(buf, ring->data + ring->head, first);
+    memcpy(buf + first, ring->data, n - first);
+
+    ring->head = (ring->head + n) % ring->size;
+    ring->len -= n;
+    ring->pos += n;
+    return n;
+}
+
 // Read a chunk of the file into the buffer, starting from read_start and respecting read_limit
 void read_stream_to_buffer(int *out_read, FILE *file, size_t read_start, size_t read_limit, unsigned char *_buffer, bool _no_seek) {
-    // Return if file is stdin
+    // stdin goes through the ring buffer, which applies offset and limit itself
     if (file == stdin) {
-        *out_read = fread(_buffer, 1, MAX_BUFF_SIZE, file);
+        *out_read = (int)stdin_read(_buffer, read_start, read_limit);
         return;
     }
 
@@ -60,6 +247,9 @@ void check_file(options *option) {
 
     if (option->pipeline == true) return;
 
+    // Diff, patch and follow modes open and check their inputs themselves.
+    if (option->diff_file || option->make_patch || option->apply_patch || option->follow || option->tail_follow) return;
+
     FILE *fp = fopen(option->filename, "rb");
 
     if (fp == NULL) {
@@ -83,6 +273,22 @@ void check_file(options *option) {
             return;
         }
 
+        // --range regions must lie inside the file.
+        for (size_t i = 0; i < option->range_count; i++) {
+            const read_range *range = &option->ranges[i];
+            if (range->offset >= file_size || range->length > file_size - range->offset) {
+                printf("Filesize is out of range, check range %zu:%zu", range->offset, range->length);
+                fclose(fp);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        // --tail: the last tail_size bytes before the limit (or EOF).
+        if (option->tail_size != 0) {
+            size_t end = option->limit_read != 0 ? option->limit_read : file_size;
+            option->offset_read = end > option->tail_size ? end - option->tail_size : 0;
+        }
+
         // Ceck if filesize is in range of limit
         if (file_size < option->limit_read) {
             printf("Filesize is out of range, check limit | keep empty for EOF");
@@ -109,7 +315,7 @@ void check_file(options *option) {
 }
 
 // Find the minimum and maximum byte values in inside one line for heatmap scaling
-void find_extrema(unsigned char *_max, unsigned char *_min, unsigned char *line, size_t line_len) {
+void find_extrema(unsigned char *_max, unsigned char *_min, const unsigned char *line, size_t line_len) {
     
     *_min = 255;
     *_max = 0;
@@ -121,3 +327,173 @@ void find_extrema(unsigned char *_max, unsigned char *_min, unsigned char *line,
     }
     return;
 }
+
+
+// Seek to an absolute position with 64-bit offsets on every platform (plain fseek
+// takes a long, which is only 32 bits wide on Windows).
+int file_seek(FILE *file, size_t pos) {
+    #ifdef _WIN32
+    return _fseeki64(file, (__int64)pos, SEEK_SET);
+    #else
+    return fseeko(file, (off_t)pos, SEEK_SET);
+    #endif
+}
+
+// Absolute end of the requested read range, 0 if the range is open (stdin without -r/-l).
+size_t get_read_end(const options *option) {
+    if (option->read_size != 0) return option->offset_read + option->read_size;
+    return option->limit_read;
+}
+
+// Positions the reader at start. Files seek, streams discard everything before start.
+void range_reader_init(range_reader *reader, FILE *file, bool is_stream, size_t start, size_t end) {
+    reader->file = file;
+    reader->pos = 0;
+    reader->end = end;
+
+    if (!is_stream) {
+        file_seek(file, start);
+        reader->pos = start;
+        return;
+    }
+
+    unsigned char scratch[MAX_BUFF_SIZE];
+    while (reader->pos < start) {
+        size_t to_skip = start - reader->pos < sizeof(scratch) ? start - reader->pos : sizeof(scratch);
+        size_t got = fread(scratch, 1, to_skip, file);
+        if (got == 0) break;
+        reader->pos += got;
+    }
+}
+
+// Reads up to cap bytes of the range, returns 0 once the range or the input is exhausted.
+size_t range_reader_read(range_reader *reader, unsigned char *buf, size_t cap) {
+    size_t to_read = cap;
+    if (reader->end != 0) {
+        if (reader->pos >= reader->end) return 0;
+        if (reader->end - reader->pos < to_read) to_read = reader->end - reader->pos;
+    }
+
+    size_t got = fread(buf, 1, to_read, reader->file);
+    reader->pos += got;
+    return got;
+}
+
+// Maps a whole file read-only. Returns false if it cannot be opened or mapped.
+bool map_file(const char *path, mapped_file *map) {
+    map->data = NULL;
+    map->size = 0;
+
+    #ifdef _WIN32
+    map->file_handle = NULL;
+    map->map_handle = NULL;
+
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    map->file_handle = file;
+    map->size = (size_t)size.QuadPart;
+    if (map->size == 0) return true;
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    map->map_handle = mapping;
+    map->data = (const unsigned char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!map->data) {
+        unmap_file(map);
+        return false;
+    }
+    return true;
+    #else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+
+    map->size = (size_t)st.st_size;
+    if (map->size == 0) {
+        close(fd);
+        return true;
+    }
+
+    void *data = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    madvise(data, map->size, MADV_SEQUENTIAL);
+    map->data = (const unsigned char *)data;
+    return true;
+    #endif
+}
+
+void unmap_file(mapped_file *map) {
+    #ifdef _WIN32
+    if (map->data) UnmapViewOfFile(map->data);
+    if (map->map_handle) CloseHandle(map->map_handle);
+    if (map->file_handle) CloseHandle(map->file_handle);
+    map->map_handle = NULL;
+    map->file_handle = NULL;
+    #else
+    if (map->data) munmap((void *)map->data, map->size);
+    #endif
+
+    map->data = NULL;
+    map->size = 0;
+}
+
+// Only regular files can have holes; on platforms without SEEK_DATA the probe stays off.
+void hole_probe_open(hole_probe *probe, const char *path) {
+    probe->fd = -1;
+    probe->data_end = 0;
+
+    #if !defined(_WIN32) && defined(SEEK_DATA) && defined(SEEK_HOLE)
+    struct stat st;
+    if (path && stat(path, &st) == 0 && S_ISREG(st.st_mode)) probe->fd = open(path, O_RDONLY);
+    #else
+    (void)path;
+    #endif
+}
+
+// Length of the hole at pos, cut at end; 0 when pos holds data. One probe covers a whole
+// data extent, so dense files cost two lseek calls per extent, not per read.
+size_t hole_probe_skip(hole_probe *probe, size_t pos, size_t end) {
+    if (probe->fd < 0 || pos >= end || pos < probe->data_end) return 0;
+
+    #if !defined(_WIN32) && defined(SEEK_DATA) && defined(SEEK_HOLE)
+    off_t data = lseek(probe->fd, (off_t)pos, SEEK_DATA);
+    if (data < 0) {
+        // ENXIO: no data behind pos, the rest of the file is one hole.
+        if (errno == ENXIO) return end - pos;
+        hole_probe_close(probe);
+        return 0;
+    }
+
+    if ((size_t)data > pos) return ((size_t)data < end ? (size_t)data : end) - pos;
+
+    off_t hole = lseek(probe->fd, (off_t)pos, SEEK_HOLE);
+    probe->data_end = hole < 0 ? (size_t)-1 : (size_t)hole;
+    #endif
+    return 0;
+}
+
+void hole_probe_close(hole_probe *probe) {
+    #ifndef _WIN32
+    if (probe->fd >= 0) close(probe->fd);
+    #endif
+    probe->fd = -1;
+}
@@ -0,0 +1,490 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+/* Live view of a changing file (--follow).
+ * How it works:
+ * - The range is printed once, then a copy of it and one XXH64 per block are kept.
+ * - inotify (or a poll timer) triggers a check of size and mtime; nothing is read while
+ *   both stay the same. A grown file only re-reads the blocks from the old end on. A
+ *   write in place (same size) re-reads the range, since inotify reports no offsets.
+ *   Blocks whose hash did not change are skipped; only dirty blocks are compared line
+ *   by line against the copy. A full rescan every FOLLOW_FULL_RESCAN_MS catches writes
+ *   through mmap, which raise no event and need not touch mtime.
+ * - Only lines that changed are printed, with the changed bytes highlighted, below a
+ *   row with the time of the change. Earlier output is never redrawn.
+ * - Bytes appended to the file count as changed, truncation is reported as a row.
+ *
+ * Append-only view (--tail-follow), like tail -f for binary data:
+ * - Starts at the end of the file (or -o) and only prints bytes appended afterwards.
+ * - Lines stay aligned to the width. A line that was printed partially is continued
+ *   on a new row with the same address and the already printed columns left blank.
+ */
+
+#include "Follow.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "DisplayUtils.h"
+#include "File.h"
+#include "Hash.h"
+#include "Utils.h"
+
+#include <sys/stat.h>
+
+#if defined(__linux__)
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#elif defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+
+typedef struct {
+    FILE *out;
+    const options *option;
+    size_t start;
+    size_t fixed_end;       // End of the range, 0 = follow the file size
+    size_t block;           // Block size, a multiple of the line width
+    unsigned char *shadow;  // Copy of the range as last printed
+    size_t len;
+    size_t cap;
+    uint64_t *hashes;       // One digest per block of the shadow copy
+    int addr_width;
+    bool announced;         // Change row printed for the current rescan
+} follow_state;
+
+// Size and modification time, compared to decide whether a rescan is needed at all.
+typedef struct {
+    size_t size;
+    int64_t mtime_ns;
+} file_stamp;
+
+static bool read_stamp(const char *path, file_stamp *stamp) {
+    #ifdef _WIN32
+    struct _stat64 st;
+    if (_stat64(path, &st) != 0) return false;
+    stamp->mtime_ns = (int64_t)st.st_mtime * 1000000000;
+    #else
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    #if defined(__linux__)
+    stamp->mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+    #elif defined(__APPLE__)
+    stamp->mtime_ns = (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+    #else
+    stamp->mtime_ns = (int64_t)st.st_mtime * 1000000000;
+    #endif
+    #endif
+    stamp->size = (size_t)st.st_size;
+    return true;
+}
+
+// ---- File watch ----
+
+#if defined(__linux__)
+static void watch_add(file_watch *watch) {
+    watch->wd = inotify_add_watch(watch->fd, watch->path,
+                                  IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVE_SELF | IN_DELETE_SELF);
+}
+#endif
+
+void watch_open(file_watch *watch, const char *path) {
+    watch->fd = -1;
+    watch->wd = -1;
+    watch->path = path;
+
+    #if defined(__linux__)
+    watch->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watch->fd < 0) return;
+
+    watch_add(watch);
+    if (watch->wd < 0) {
+        close(watch->fd);
+        watch->fd = -1;
+    }
+    #endif
+}
+
+// Sleeps until the file changes or timeout_ms passed. Returns true if an event arrived.
+bool watch_wait(file_watch *watch, int timeout_ms) {
+    #if defined(__linux__)
+    if (watch->fd >= 0) {
+        struct pollfd pfd = {watch->fd, POLLIN, 0};
+        if (poll(&pfd, 1, timeout_ms) <= 0) return false;
+
+        // Drain all queued events; a replaced or removed file gets a fresh watch.
+        char events[4096];
+        bool renew = false;
+        ssize_t got;
+        while ((got = read(watch->fd, events, sizeof(events))) > 0) {
+            for (ssize_t pos = 0; pos < got;) {
+                const struct inotify_event *event = (const struct inotify_event *)(events + pos);
+                if (event->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED)) renew = true;
+                pos += (ssize_t)sizeof(struct inotify_event) + event->len;
+            }
+        }
+
+        if (renew) {
+            inotify_rm_watch(watch->fd, watch->wd);
+            watch_add(watch);
+        }
+        return true;
+    }
+    #endif
+
+    #if defined(_WIN32)
+    Sleep((DWORD)timeout_ms);
+    #else
+    usleep((useconds_t)timeout_ms * 1000);
+    #endif
+    return false;
+}
+
+void watch_close(file_watch *watch) {
+    #if defined(__linux__)
+    if (watch->fd >= 0) close(watch->fd);
+    #endif
+    watch->fd = -1;
+}
+
+// ---- Rendering ----
+
+static void print_line(follow_state *state, size_t pos, const unsigned char *now, size_t now_len,
+                       const unsigned char *before, size_t before_len) {
+    const options *option = state->option;
+    char line[MAX_LINE_SIZE];
+    size_t line_pos = 0;
+    line[0] = '\0';
+
+    if (option->color) {
+        append_to_line(line, MAX_LINE_SIZE, &line_pos, "%s%0*zX %s| %s",
+                       ADDR_COLOR, state->addr_width, state->start + pos, BORDER_COLOR, RESET);
+    } else {
+        append_to_line(line, MAX_LINE_SIZE, &line_pos, "%0*zX | ", state->addr_width, state->start + pos);
+    }
+
+    append_compare_side(line, &line_pos, option, 0, now, now_len, before, before_len);
+    fprintf(state->out, "%s\n", line);
+}
+
+// Prints the time row once per rescan, right before its first changed line.
+static void announce_change(follow_state *state, size_t size) {
+    if (state->announced) return;
+    state->announced = true;
+
+    char stamp[32] = "n/a";
+    format_time_local(time(NULL), stamp, sizeof(stamp));
+    print_report_row(state->out, state->option, "change", "%s ; size %zu B", stamp, size);
+}
+
+static void ensure_capacity(follow_state *state, size_t len) {
+    if (len <= state->cap) return;
+
+    size_t cap = state->cap ? state->cap : state->block * 16;
+    while (cap < len) cap *= 2;
+
+    unsigned char *shadow = realloc(state->shadow, cap);
+    uint64_t *hashes = realloc(state->hashes, (cap / state->block + 1) * sizeof(uint64_t));
+    if (!shadow || !hashes) {
+        perror("Malloc failed for follow buffer");
+        exit(EXIT_FAILURE);
+    }
+
+    state->shadow = shadow;
+    state->hashes = hashes;
+    state->cap = cap;
+}
+
+// Re-reads the range from the block holding byte from (relative to the range start) and
+// prints the lines that differ from the shadow copy. Blocks before it are taken as
+// unchanged. On the first pass (initial) every line is printed without highlighting.
+static void follow_rescan(follow_state *state, const char *filename, size_t from, bool initial) {
+    file_metadata meta;
+    if (!get_file_metadata(filename, &meta)) return;    // Rotated away, wait for it to return
+
+    size_t end = meta.file_size;
+    if (state->fixed_end != 0 && state->fixed_end < end) end = state->fixed_end;
+    size_t len = end > state->start ? end - state->start : 0;
+
+    state->announced = false;
+
+    if (len < state->len) {
+        announce_change(state, meta.file_size);
+        print_report_row(state->out, state->option, "truncate", "range %zu -> %zu B", state->len, len);
+        state->len = len;
+    }
+
+    FILE *file = fopen(filename, "rb");
+    if (!file) return;
+
+    unsigned char *chunk = malloc(state->block);
+    if (!chunk) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    ensure_capacity(state, len);
+
+    size_t width = (size_t)state->option->buff_size;
+    size_t old_len = state->len;
+    size_t first = from / state->block * state->block;
+    file_seek(file, state->start + first);
+
+    for (size_t pos = first; pos < len; pos += state->block) {
+        size_t want = len - pos < state->block ? len - pos : state->block;
+        size_t got = fread(chunk, 1, want, file);
+        if (got == 0) {
+            len = pos;
+            break;
+        }
+
+        uint64_t digest = xxh64(chunk, got, 0);
+        size_t blk = pos / state->block;
+        bool was_full = pos + got <= old_len;
+
+        if (!initial && was_full && state->hashes[blk] == digest) continue;
+
+        for (size_t rel = 0; rel < got; rel += width) {
+            size_t line_len = got - rel < width ? got - rel : width;
+            size_t abs = pos + rel;
+            size_t before_len = abs < old_len ? old_len - abs : 0;
+            if (before_len > width) before_len = width;
+
+            if (initial) {
+                print_line(state, abs, chunk + rel, line_len, chunk + rel, line_len);
+                continue;
+            }
+
+            if (before_len == line_len && memcmp(chunk + rel, state->shadow + abs, line_len) == 0) continue;
+
+            announce_change(state, meta.file_size);
+            print_line(state, abs, chunk + rel, line_len, state->shadow + abs, before_len);
+        }
+
+        memcpy(state->shadow + pos, chunk, got);
+        state->hashes[blk] = digest;
+    }
+
+    if (len > state->len || initial) state->len = len;
+
+    free(chunk);
+    fclose(file);
+    fflush(state->out);
+}
+
+void follow_file(options *option) {
+    file_metadata meta;
+    if (!get_file_metadata(option->filename, &meta)) {
+        perror("File not found / No permission to read");
+        exit(EXIT_FAILURE);
+    }
+
+    follow_state state = {0};
+    state.out = stdout;
+    state.option = option;
+    state.start = option->offset_read;
+    state.fixed_end = get_read_end(option);
+
+    size_t width = (size_t)option->buff_size;
+    state.block = (FOLLOW_BLOCK_SIZE + width - 1) / width * width;
+
+    size_t max_addr = state.fixed_end ? state.fixed_end : meta.file_size;
+    state.addr_width = _hex_digits_size_t(max_addr);
+    if (state.addr_width < 8) state.addr_width = 8;
+
+    file_watch watch;
+    watch_open(&watch, option->filename);
+
+    if (!option->skip_header && !option->raw) {
+        int row_width = state.addr_width + 3 + compare_side_width(option);
+        if (option->color) fprintf(stdout, "%s", HEADER_COLOR);
+        fprintf(stdout, "\nfollow %s (%s, ctrl-c to stop):\n", option->filename, watch.fd >= 0 ? "inotify" : "polling");
+        if (option->color) fprintf(stdout, "%s", BORDER_COLOR);
+        for (int i = 0; i < row_width; i++) fputc('-', stdout);
+        if (option->color) fprintf(stdout, "%s", RESET);
+        fputc('\n', stdout);
+    }
+
+    file_stamp seen = {0};
+    read_stamp(option->filename, &seen);
+    follow_rescan(&state, option->filename, 0, true);
+    time_t last_full = time(NULL);
+
+    while (1) {
+        watch_wait(&watch, watch.fd >= 0 ? FOLLOW_RESCAN_MS : FOLLOW_POLL_MS);
+
+        file_stamp now;
+        if (!read_stamp(option->filename, &now)) continue;     // Rotated away, wait for it to return
+
+        bool full_due = difftime(time(NULL), last_full) * 1000.0 >= FOLLOW_FULL_RESCAN_MS;
+        bool changed = now.size != seen.size || now.mtime_ns != seen.mtime_ns;
+        if (!changed && !full_due) continue;
+
+        // Appends only touch the blocks from the old end on; anything else may be anywhere.
+        size_t from = 0;
+        if (!full_due && now.size > seen.size && seen.size > state.start) from = seen.size - state.start;
+
+        follow_rescan(&state, option->filename, from, false);
+        if (from == 0) last_full = time(NULL);
+        seen = now;
+    }
+}
+
+// ---- Append-only view ----
+
+typedef struct {
+    FILE *out;
+    const options *option;
+    size_t pos;             // Absolute offset of the next byte to read
+    size_t end;             // End of the range, 0 = no end
+    unsigned char *row;     // Bytes of the current line
+    size_t row_start;       // Absolute offset of the current line
+    size_t row_printed;     // Bytes of the current line already printed
+    size_t row_filled;      // Bytes of the current line known so far
+    int addr_width;
+} tail_state;
+
+// Prints the not yet printed part of the current line and starts a new line when full.
+static void tail_flush_row(tail_state *state) {
+    const options *option = state->option;
+    if (state->row_filled == state->row_printed) return;
+
+    char line[MAX_LINE_SIZE];
+    size_t line_pos = 0;
+    line[0] = '\0';
+
+    if (option->raw) {
+        for (size_t i = state->row_printed; i < state->row_filled; i++) {
+            append_to_line(line, MAX_LINE_SIZE, &line_pos, "%02x", state->row[i]);
+        }
+    } else {
+        if (option->color) {
+            append_to_line(line, MAX_LINE_SIZE, &line_pos, "%s%0*zX %s| %s",
+                           ADDR_COLOR, state->addr_width, state->row_start, BORDER_COLOR, RESET);
+        } else {
+            append_to_line(line, MAX_LINE_SIZE, &line_pos, "%0*zX | ", state->addr_width, state->row_start);
+        }
+        append_compare_side(line, &line_pos, option, state->row_printed,
+                            state->row, state->row_filled, state->row, state->row_filled);
+    }
+
+    fprintf(state->out, "%s\n", line);
+    state->row_printed = state->row_filled;
+
+    if (state->row_filled == (size_t)option->buff_size) {
+        state->row_start += state->row_filled;
+        state->row_printed = 0;
+        state->row_filled = 0;
+    }
+}
+
+// Positions the line state at an absolute offset, keeping lines aligned to the width.
+static void tail_seek(tail_state *state, size_t pos) {
+    size_t width = (size_t)state->option->buff_size;
+    state->pos = pos;
+    state->row_start = pos / width * width;
+    state->row_printed = pos - state->row_start;
+    state->row_filled = state->row_printed;
+}
+
+// Reads and prints everything appended since the last call. Returns false at the range end.
+static bool tail_drain(tail_state *state, FILE *file, unsigned char *chunk, size_t chunk_size) {
+    size_t width = (size_t)state->option->buff_size;
+
+    while (state->end == 0 || state->pos < state->end) {
+        size_t want = chunk_size;
+        if (state->end != 0 && state->end - state->pos < want) want = state->end - state->pos;
+
+        size_t got = fread(chunk, 1, want, file);
+        if (got == 0) break;
+
+        for (size_t i = 0; i < got;) {
+            size_t take = width - state->row_filled;
+            if (take > got - i) take = got - i;
+
+            memcpy(state->row + state->row_filled, chunk + i, take);
+            state->row_filled += take;
+            i += take;
+
+            if (state->row_filled == width) tail_flush_row(state);
+        }
+        state->pos += got;
+    }
+
+    // A partial line is shown right away and continued later.
+    tail_flush_row(state);
+    clearerr(file);
+    fflush(state->out);
+    return state->end == 0 || state->pos < state->end;
+}
+
+void tail_follow_file(options *option) {
+    file_metadata meta;
+    FILE *file = fopen(option->filename, "rb");
+    if (!file || !get_file_metadata(option->filename, &meta)) {
+        perror("File not found / No permission to read");
+        exit(EXIT_FAILURE);
+    }
+
+    tail_state state = {0};
+    state.out = stdout;
+    state.option = option;
+    state.end = get_read_end(option);
+    state.row = malloc((size_t)option->buff_size);
+
+    enum { TAIL_CHUNK = 65536 };
+    unsigned char *chunk = malloc(TAIL_CHUNK);
+    if (!state.row || !chunk) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // -o starts there, --tail that many bytes before the end, otherwise only bytes
+    // written from now on are shown.
+    size_t start = option->offset_read != 0 ? option->offset_read : meta.file_size;
+    if (option->tail_size != 0) start = meta.file_size > option->tail_size ? meta.file_size - option->tail_size : 0;
+    if (state.end != 0 && start > state.end) start = state.end;
+
+    state.addr_width = _hex_digits_size_t(state.end ? state.end : meta.file_size * 2 + 1);
+    if (state.addr_width < 8) state.addr_width = 8;
+    tail_seek(&state, start);
+    file_seek(file, start);
+
+    file_watch watch;
+    watch_open(&watch, option->filename);
+
+    if (!option->skip_header && !option->raw) {
+        if (option->color) fprintf(stdout, "%s", HEADER_COLOR);
+        fprintf(stdout, "\ntail-follow %s from %zu (%s, ctrl-c to stop):\n",
+                option->filename, start, watch.fd >= 0 ? "inotify" : "polling");
+        if (option->color) fprintf(stdout, "%s", RESET);
+    }
+
+    while (tail_drain(&state, file, chunk, TAIL_CHUNK)) {
+        watch_wait(&watch, watch.fd >= 0 ? FOLLOW_RESCAN_MS : FOLLOW_POLL_MS);
+
+        // Truncated (e.g. a restarted capture): continue from the new start like tail -f.
+        if (get_file_metadata(option->filename, &meta) && meta.file_size < state.pos) {
+            if (!option->raw) {
+                print_report_row(stdout, option, "truncate", "size %zu B, continuing at 0", meta.file_size);
+            }
+            tail_seek(&state, 0);
+            file_seek(file, 0);
+        }
+    }
+
+    watch_close(&watch);
+    free(chunk);
+    free(state.row);
+    fclose(file);
+}
@@ -0,0 +1,607 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+/* Digest implementations used by the dedup, diff and checksum features.
+ * - XXH64 follows the reference specification (https://github.com/Cyan4973/xxHash).
+ * - CRC-32C uses the SSE4.2 crc32 instruction, CRC-32 uses PCLMULQDQ folding
+ *   ("Fast CRC Computation for Generic Polynomials Using PCLMULQDQ", Intel 2009)
+ *   and SHA-256 uses the SHA-NI round instructions when the CPU has them.
+ *   Otherwise slicing-by-8 tables and the FIPS 180-4 reference rounds are used.
+ */
+
+#include "Hash.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "Cpu.h"
+
+#if defined(HXED_X86)
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <immintrin.h>
+    #endif
+#endif
+
+#define XXH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define XXH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define XXH_PRIME64_3 0x165667B19E3779F9ULL
+#define XXH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define XXH_PRIME64_5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t rotl64(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Little-endian loads; memcpy keeps them alignment-safe and compiles to a single mov.
+static inline uint64_t read64_le(const unsigned char *p) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+    #endif
+    return value;
+}
+
+static inline uint32_t read32_le(const unsigned char *p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap32(value);
+    #endif
+    return value;
+}
+
+static inline uint64_t xxh64_round(uint64_t acc, uint64_t input) {
+    acc += input * XXH_PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * XXH_PRIME64_1;
+}
+
+static inline uint64_t xxh64_merge_round(uint64_t acc, uint64_t value) {
+    acc ^= xxh64_round(0, value);
+    return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+void xxh64_init(xxh64_state *state, uint64_t seed) {
+    memset(state, 0, sizeof(*state));
+    state->seed = seed;
+    state->v[0] = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+    state->v[1] = seed + XXH_PRIME64_2;
+    state->v[2] = seed;
+    state->v[3] = seed - XXH_PRIME64_1;
+}
+
+void xxh64_update(xxh64_state *state, const void *data, size_t len) {
+    const unsigned char *p = (const unsigned char *)data;
+    const unsigned char *end = p + len;
+
+    state->total_len += len;
+
+    // Not enough for a full 32 byte stripe yet.
+    if (state->mem_size + len < 32) {
+        memcpy(state->mem + state->mem_size, p, len);
+        state->mem_size += len;
+        return;
+    }
+
+    if (state->mem_size > 0) {
+        size_t fill = 32 - state->mem_size;
+        memcpy(state->mem + state->mem_size, p, fill);
+        for (int i = 0; i < 4; i++) {
+            state->v[i] = xxh64_round(state->v[i], read64_le(state->mem + i * 8));
+        }
+        p += fill;
+        state->mem_size = 0;
+    }
+
+    uint64_t v1 = state->v[0];
+    uint64_t v2 = state->v[1];
+    uint64_t v3 = state->v[2];
+    uint64_t v4 = state->v[3];
+
+    while (p + 32 <= end) {
+        v1 = xxh64_round(v1, read64_le(p));
+        v2 = xxh64_round(v2, read64_le(p + 8));
+        v3 = xxh64_round(v3, read64_le(p + 16));
+        v4 = xxh64_round(v4, read64_le(p + 24));
+        p += 32;
+    }
+
+    state->v[0] = v1;
+    state->v[1] = v2;
+    state->v[2] = v3;
+    state->v[3] = v4;
+
+    if (p < end) {
+        state->mem_size = (size_t)(end - p);
+        memcpy(state->mem, p, state->mem_size);
+    }
+}
+
+uint64_t xxh64_digest(const xxh64_state *state) {
+    uint64_t h;
+
+    if (state->total_len >= 32) {
+        h = rotl64(state->v[0], 1) + rotl64(state->v[1], 7) + rotl64(state->v[2], 12) + rotl64(state->v[3], 18);
+        for (int i = 0; i < 4; i++) {
+            h = xxh64_merge_round(h, state->v[i]);
+        }
+    } else {
+        h = state->seed + XXH_PRIME64_5;
+    }
+
+    h += state->total_len;
+
+    const unsigned char *p = state->mem;
+    const unsigned char *end = p + state->mem_size;
+
+    while (p + 8 <= end) {
+        h ^= xxh64_round(0, read64_le(p));
+        h = rotl64(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        p += 8;
+    }
+
+    if (p + 4 <= end) {
+        h ^= (uint64_t)read32_le(p) * XXH_PRIME64_1;
+        h = rotl64(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+    }
+
+    while (p < end) {
+        h ^= (uint64_t)(*p) * XXH_PRIME64_5;
+        h = rotl64(h, 11) * XXH_PRIME64_1;
+        p++;
+    }
+
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+// One-shot XXH64 of a buffer.
+uint64_t xxh64(const void *data, size_t len, uint64_t seed) {
+    xxh64_state state;
+    xxh64_init(&state, seed);
+    xxh64_update(&state, data, len);
+    return xxh64_digest(&state);
+}
+
+// ---- CRC-32 / CRC-32C ----
+
+static uint32_t crc32_table[8][256];
+static uint32_t crc32c_table[8][256];
+
+static void build_crc_table(uint32_t table[8][256], uint32_t poly) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (poly & (0u - (crc & 1)));
+        table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int t = 1; t < 8; t++) {
+            table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xFF];
+        }
+    }
+}
+
+// Builds the slicing tables. Called from main before any worker can hash.
+void init_crc_tables(void) {
+    build_crc_table(crc32_table, 0xEDB88320u);
+    build_crc_table(crc32c_table, 0x82F63B78u);
+}
+
+// Slicing-by-8 on the inverted CRC register.
+static uint32_t crc_slice8(uint32_t table[8][256], uint32_t crc, const unsigned char *p, size_t len) {
+    while (len >= 8) {
+        uint32_t lo = read32_le(p) ^ crc;
+        uint32_t hi = read32_le(p + 4);
+        crc = table[7][lo & 0xFF] ^ table[6][(lo >> 8) & 0xFF] ^
+              table[5][(lo >> 16) & 0xFF] ^ table[4][lo >> 24] ^
+              table[3][hi & 0xFF] ^ table[2][(hi >> 8) & 0xFF] ^
+              table[1][(hi >> 16) & 0xFF] ^ table[0][hi >> 24];
+        p += 8;
+        len -= 8;
+    }
+
+    while (len-- > 0) {
+        crc = (crc >> 8) ^ table[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(HXED_X86) && (defined(__x86_64__) || defined(_M_X64))
+HXED_TARGET("sse4.2")
+static uint32_t crc32c_sse42(uint32_t crc, const unsigned char *p, size_t len) {
+    uint64_t crc64 = crc;
+
+    while (len >= 8) {
+        crc64 = _mm_crc32_u64(crc64, read64_le(p));
+        p += 8;
+        len -= 8;
+    }
+
+    crc = (uint32_t)crc64;
+    while (len-- > 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+
+// Folds 64 bytes per iteration with four 128-bit accumulators, then reduces to 32 bits
+// with a Barrett reduction. len must be a multiple of 16 and at least 64.
+HXED_TARGET("pclmul,sse4.1")
+static uint32_t crc32_pclmul(uint32_t crc, const unsigned char *p, size_t len) {
+    const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+    const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+    const __m128i k5k0 = _mm_set_epi64x(0x0000000000LL, 0x0163cd6124LL);
+    const __m128i poly = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    __m128i x1 = _mm_loadu_si128((const __m128i *)(p + 0x00));
+    __m128i x2 = _mm_loadu_si128((const __m128i *)(p + 0x10));
+    __m128i x3 = _mm_loadu_si128((const __m128i *)(p + 0x20));
+    __m128i x4 = _mm_loadu_si128((const __m128i *)(p + 0x30));
+    __m128i x0, x5, x6, x7, x8;
+
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    p += 64;
+    len -= 64;
+
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, k1k2, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, k1k2, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, k1k2, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, k1k2, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, k1k2, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k1k2, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k1k2, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k1k2, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i *)(p + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i *)(p + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i *)(p + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i *)(p + 0x30)));
+
+        p += 64;
+        len -= 64;
+    }
+
+    // Fold the four accumulators into one.
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+    x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    // Remaining 16 byte blocks.
+    while (len >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, k3k4, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k3k4, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *)p)), x5);
+        p += 16;
+        len -= 16;
+    }
+
+    // 128 -> 64 bits.
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+    x0 = k5k0;
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask32);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits.
+    x2 = _mm_and_si128(x1, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask32);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (uint32_t)_mm_extract_epi32(x1, 1);
+}
+#endif
+
+uint32_t crc32_update(uint32_t crc, const void *data, size_t len) {
+    const unsigned char *p = (const unsigned char *)data;
+    crc = ~crc;
+
+    #if defined(HXED_X86) && (defined(__x86_64__) || defined(_M_X64))
+    if (len >= 64 && get_cpu_features()->pclmul) {
+        size_t folded = len & ~(size_t)15;
+        crc = crc32_pclmul(crc, p, folded);
+        p += folded;
+        len -= folded;
+    }
+    #endif
+
+    return ~crc_slice8(crc32_table, crc, p, len);
+}
+
+uint32_t crc32c_update(uint32_t crc, const void *data, size_t len) {
+    const unsigned char *p = (const unsigned char *)data;
+    crc = ~crc;
+
+    #if defined(HXED_X86) && (defined(__x86_64__) || defined(_M_X64))
+    if (get_cpu_features()->sse42) return ~crc32c_sse42(crc, p, len);
+    #endif
+
+    return ~crc_slice8(crc32c_table, crc, p, len);
+}
+
+// ---- SHA-256 ----
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline uint32_t rotr32(uint32_t value, int bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+static inline uint32_t read32_be(const unsigned char *p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void sha256_blocks_scalar(uint32_t h[8], const unsigned char *p, size_t blocks) {
+    uint32_t w[64];
+
+    while (blocks-- > 0) {
+        for (int i = 0; i < 16; i++) w[i] = read32_be(p + i * 4);
+        for (int i = 16; i < 64; i++) {
+            uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3];
+        uint32_t e = h[4], f = h[5], g = h[6], k = h[7];
+
+        for (int i = 0; i < 64; i++) {
+            uint32_t s1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+            uint32_t ch = (e & f) ^ (~e & g);
+            uint32_t t1 = k + s1 + ch + sha256_k[i] + w[i];
+            uint32_t s0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+            uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t t2 = s0 + maj;
+
+            k = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+        h[4] += e; h[5] += f; h[6] += g; h[7] += k;
+        p += 64;
+    }
+}
+
+#if defined(HXED_X86)
+// SHA-NI: four rounds per sha256rnds2 pair, message schedule with sha256msg1/msg2.
+// The state is kept as ABEF / CDGH as the instructions expect.
+HXED_TARGET("sha,sse4.1,ssse3")
+static void sha256_blocks_shani(uint32_t h[8], const unsigned char *p, size_t blocks) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+    __m128i tmp = _mm_loadu_si128((const __m128i *)&h[0]);
+    __m128i state1 = _mm_loadu_si128((const __m128i *)&h[4]);
+
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);                 // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1B);           // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);   // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);        // CDGH
+
+    while (blocks-- > 0) {
+        __m128i abef_save = state0;
+        __m128i cdgh_save = state1;
+        __m128i msg[4];
+
+        for (int i = 0; i < 16; i++) {
+            if (i < 4) {
+                msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p + i * 16)), byte_swap);
+            }
+
+            __m128i m = _mm_add_epi32(msg[i & 3], _mm_loadu_si128((const __m128i *)&sha256_k[i * 4]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, m);
+
+            if (i >= 3 && i <= 14) {
+                __m128i t = _mm_alignr_epi8(msg[i & 3], msg[(i + 3) & 3], 4);
+                msg[(i + 1) & 3] = _mm_add_epi32(msg[(i + 1) & 3], t);
+                msg[(i + 1) & 3] = _mm_sha256msg2_epu32(msg[(i + 1) & 3], msg[i & 3]);
+            }
+
+            m = _mm_shuffle_epi32(m, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, m);
+
+            if (i >= 1 && i <= 12) {
+                msg[(i + 3) & 3] = _mm_sha256msg1_epu32(msg[(i + 3) & 3], msg[i & 3]);
+            }
+        }
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+        p += 64;
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);              // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);           // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);        // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);           // HGFE
+
+    _mm_storeu_si128((__m128i *)&h[0], state0);
+    _mm_storeu_si128((__m128i *)&h[4], state1);
+}
+#endif
+
+static void sha256_blocks(uint32_t h[8], const unsigned char *p, size_t blocks) {
+    #if defined(HXED_X86)
+    if (get_cpu_features()->sha) {
+        sha256_blocks_shani(h, p, blocks);
+        return;
+    }
+    #endif
+    sha256_blocks_scalar(h, p, blocks);
+}
+
+void sha256_init(sha256_state *state) {
+    static const uint32_t initial[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    memcpy(state->h, initial, sizeof(initial));
+    state->total_len = 0;
+    state->buf_len = 0;
+}
+
+void sha256_update(sha256_state *state, const void *data, size_t len) {
+    const unsigned char *p = (const unsigned char *)data;
+    state->total_len += len;
+
+    if (state->buf_len > 0) {
+        size_t fill = 64 - state->buf_len;
+        if (fill > len) fill = len;
+        memcpy(state->buf + state->buf_len, p, fill);
+        state->buf_len += fill;
+        p += fill;
+        len -= fill;
+
+        if (state->buf_len < 64) return;
+        sha256_blocks(state->h, state->buf, 1);
+        state->buf_len = 0;
+    }
+
+    if (len >= 64) {
+        sha256_blocks(state->h, p, len / 64);
+        p += len & ~(size_t)63;
+        len &= 63;
+    }
+
+    memcpy(state->buf, p, len);
+    state->buf_len = len;
+}
+
+void sha256_final(sha256_state *state, unsigned char out[32]) {
+    uint64_t bits = state->total_len * 8;
+    unsigned char pad[72] = {0x80};
+    size_t pad_len = (state->buf_len < 56) ? 56 - state->buf_len : 120 - state->buf_len;
+
+    for (int i = 0; i < 8; i++) pad[pad_len + i] = (unsigned char)(bits >> (56 - i * 8));
+    sha256_update(state, pad, pad_len + 8);
+
+    for (int i = 0; i < 8; i++) {
+        out[i * 4 + 0] = (unsigned char)(state->h[i] >> 24);
+        out[i * 4 + 1] = (unsigned char)(state->h[i] >> 16);
+        out[i * 4 + 2] = (unsigned char)(state->h[i] >> 8);
+        out[i * 4 + 3] = (unsigned char)(state->h[i]);
+    }
+}
+
+// ---- Digest set (--hash) ----
+
+static const struct {
+    const char *name;
+    unsigned int flag;
+} hash_algorithms[] = {
+    {"crc32", HASH_CRC32},
+    {"crc32c", HASH_CRC32C},
+    {"xxh64", HASH_XXH64},
+    {"sha256", HASH_SHA256},
+};
+
+#define HASH_ALGORITHM_COUNT (sizeof(hash_algorithms) / sizeof(hash_algorithms[0]))
+
+const char *hash_name(unsigned int algorithm) {
+    for (size_t i = 0; i < HASH_ALGORITHM_COUNT; i++) {
+        if (hash_algorithms[i].flag == algorithm) return hash_algorithms[i].name;
+    }
+    return "?";
+}
+
+// Parses a comma separated algorithm list ("crc32c,xxh64"), -1 on unknown names.
+int parse_hash_list(const char *list) {
+    unsigned int mask = 0;
+    const char *p = list;
+
+    while (*p) {
+        const char *end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        bool found = false;
+
+        for (size_t i = 0; i < HASH_ALGORITHM_COUNT; i++) {
+            if (strlen(hash_algorithms[i].name) == len && strncmp(p, hash_algorithms[i].name, len) == 0) {
+                mask |= hash_algorithms[i].flag;
+                found = true;
+            }
+        }
+
+        if (!found) return -1;
+        p += len;
+        if (*p == ',') p++;
+    }
+
+    return mask ? (int)mask : -1;
+}
+
+void digest_set_init(digest_set *set, unsigned int mask) {
+    memset(set, 0, sizeof(*set));
+    set->mask = mask;
+    xxh64_init(&set->xxh, 0);
+    sha256_init(&set->sha);
+}
+
+void digest_set_update(digest_set *set, const void *data, size_t len) {
+    if (set->mask & HASH_CRC32) set->crc32 = crc32_update(set->crc32, data, len);
+    if (set->mask & HASH_CRC32C) set->crc32c = crc32c_update(set->crc32c, data, len);
+    if (set->mask & HASH_XXH64) xxh64_update(&set->xxh, data, len);
+    if (set->mask & HASH_SHA256) sha256_update(&set->sha, data, len);
+}
+
+// Formats the final digest of one algorithm as lowercase hex. SHA-256 is finalized
+// on a copy, so the set can keep accumulating.
+void digest_set_format(digest_set *set, unsigned int algorithm, char *out, size_t out_size) {
+    switch (algorithm) {
+        case HASH_CRC32:
+            snprintf(out, out_size, "%08x", set->crc32);
+            break;
+        case HASH_CRC32C:
+            snprintf(out, out_size, "%08x", set->crc32c);
+            break;
+        case HASH_XXH64:
+            snprintf(out, out_size, "%016llx", (unsigned long long)xxh64_digest(&set->xxh));
+            break;
+        case HASH_SHA256: {
+            sha256_state copy = set->sha;
+            unsigned char digest[32];
+            sha256_final(&copy, digest);
+            for (int i = 0; i < 32 && (size_t)(i * 2 + 2) < out_size; i++) {
+                snprintf(out + i * 2, out_size - (size_t)i * 2, "%02x", digest[i]);
+            }
+            break;
+        }
+        default:
+            snprintf(out, out_size, "n/a");
+            break;
+    }
+}
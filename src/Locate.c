@@ -0,0 +1,364 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+/* Block provenance lookup (--locate NEEDLE HAYSTACK).
+ * How it works:
+ * - The needle is cut into fixed blocks. Each block gets a polynomial rolling hash and
+ *   goes into a small open addressing index. Blocks of a single repeated byte (padding)
+ *   are not indexed, they would match every fill region of the haystack.
+ * - Both files are memory mapped. The haystack range is split into one segment per
+ *   worker and every worker rolls the hash over its segment byte by byte, so the
+ *   haystack is read once no matter how many blocks the needle has.
+ * - A hash hit is verified with memcmp. After a match the window jumps one block ahead
+ *   (as in rsync), so a match is never reported twice with overlapping bytes. Segment
+ *   borders are repaired afterwards, the result equals a single sequential scan.
+ * - Matches are merged into runs where both offsets advance together and printed in
+ *   haystack order.
+ */
+
+#include "Locate.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "DisplayUtils.h"
+#include "File.h"
+#include "Threads.h"
+#include "Utils.h"
+
+// One indexed needle block. Equal blocks are indexed once, at their first offset.
+typedef struct {
+    uint64_t hash;
+    size_t offset;          // Needle offset + 1, 0 = empty slot
+} locate_slot;
+
+typedef struct {
+    size_t haystack;
+    size_t needle;
+} locate_match;
+
+typedef struct {
+    locate_match *items;
+    size_t count;
+    size_t cap;
+} match_list;
+
+// Shared state for the scan workers.
+typedef struct {
+    const unsigned char *needle;
+    const unsigned char *haystack;
+    size_t block;
+    size_t start;           // First window position of the haystack range
+    size_t last;            // Last window position + 1
+    locate_slot *slots;
+    size_t slot_mask;
+    uint64_t out_table[256];    // byte * PRIME^block, removes the byte leaving the window
+    uint64_t filter[LOCATE_FILTER_BITS / 64];   // Top hash bits of all indexed blocks
+    match_list found[MAX_WORKERS];
+} locate_job;
+
+static uint64_t block_hash(const unsigned char *data, size_t len) {
+    uint64_t hash = 0;
+    for (size_t i = 0; i < len; i++) hash = hash * LOCATE_HASH_PRIME + data[i];
+    return hash;
+}
+
+// The polynomial hash is weak in its low bits, so slots are picked from mixed high bits.
+static size_t slot_of(uint64_t hash, size_t mask) {
+    return (size_t)((hash * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+static void push_match(match_list *list, size_t haystack, size_t needle) {
+    if (list->count == list->cap) {
+        size_t cap = list->cap ? list->cap * 2 : 256;
+        locate_match *items = realloc(list->items, cap * sizeof(locate_match));
+        if (!items) {
+            perror("Malloc failed");
+            exit(EXIT_FAILURE);
+        }
+        list->items = items;
+        list->cap = cap;
+    }
+
+    list->items[list->count].haystack = haystack;
+    list->items[list->count].needle = needle;
+    list->count++;
+}
+
+// Returns the needle offset of a verified match at haystack position pos, or SIZE_MAX.
+static size_t lookup(const locate_job *job, uint64_t hash, size_t pos) {
+    for (size_t slot = slot_of(hash, job->slot_mask); job->slots[slot].offset; slot = (slot + 1) & job->slot_mask) {
+        if (job->slots[slot].hash != hash) continue;
+
+        size_t needle_off = job->slots[slot].offset - 1;
+        if (memcmp(job->needle + needle_off, job->haystack + pos, job->block) == 0) return needle_off;
+    }
+    return SIZE_MAX;
+}
+
+// Finds the first match with a window position in [pos, stop). Returns false if there is none.
+static bool scan_first(const locate_job *job, size_t pos, size_t stop, locate_match *match) {
+    if (pos >= stop) return false;
+
+    const unsigned char *hay = job->haystack;
+    size_t block = job->block;
+    uint64_t hash = block_hash(hay + pos, block);
+
+    for (;;) {
+        // Most windows are rejected by the filter, which stays in L1.
+        uint64_t bit = hash >> (64 - LOCATE_FILTER_SHIFT);
+        if (job->filter[bit >> 6] & (1ULL << (bit & 63))) {
+            size_t needle_off = lookup(job, hash, pos);
+            if (needle_off != SIZE_MAX) {
+                match->haystack = pos;
+                match->needle = needle_off;
+                return true;
+            }
+        }
+
+        if (pos + 1 >= stop) return false;
+        hash = hash * LOCATE_HASH_PRIME - job->out_table[hay[pos]] + hay[pos + block];
+        pos++;
+    }
+}
+
+static void segment_bounds(const locate_job *job, int worker_id, int worker_count, size_t *first, size_t *stop) {
+    size_t span = job->last - job->start;
+    *first = job->start + span * (size_t)worker_id / (size_t)worker_count;
+    *stop = job->start + span * (size_t)(worker_id + 1) / (size_t)worker_count;
+}
+
+// After a match the scan continues one block later, so matches never overlap.
+static void locate_worker(void *ctx, int worker_id, int worker_count) {
+    locate_job *job = (locate_job *)ctx;
+    size_t pos, stop;
+    segment_bounds(job, worker_id, worker_count, &pos, &stop);
+
+    locate_match match;
+    while (scan_first(job, pos, stop, &match)) {
+        push_match(&job->found[worker_id], match.haystack, match.needle);
+        pos = match.haystack + job->block;
+    }
+}
+
+// Joins the segment results into the sequence a single sequential scan would find.
+// A match hanging into the next segment shifts where that scan resumes; the gap is
+// rescanned until it meets a match of the segment again, from there both agree.
+static void merge_segments(locate_job *job, int workers, match_list *all) {
+    size_t pos = job->start;
+    locate_match match;
+
+    for (int w = 0; w < workers; w++) {
+        size_t first, stop;
+        segment_bounds(job, w, workers, &first, &stop);
+        bool synced = pos == first;
+        const match_list *found = &job->found[w];
+
+        for (size_t i = 0; i < found->count; i++) {
+            locate_match m = found->items[i];
+            if (m.haystack < pos) continue;
+
+            if (!synced) {
+                while (scan_first(job, pos, m.haystack, &match)) {
+                    push_match(all, match.haystack, match.needle);
+                    pos = match.haystack + job->block;
+                }
+                if (m.haystack < pos) continue;
+                synced = true;
+            }
+
+            push_match(all, m.haystack, m.needle);
+            pos = m.haystack + job->block;
+        }
+
+        if (!synced) {
+            while (scan_first(job, pos, stop, &match)) {
+                push_match(all, match.haystack, match.needle);
+                pos = match.haystack + job->block;
+            }
+        }
+        if (pos < stop) pos = stop;
+        free(found->items);
+    }
+}
+
+static bool is_fill_block(const unsigned char *data, size_t len) {
+    for (size_t i = 1; i < len; i++) {
+        if (data[i] != data[0]) return false;
+    }
+    return true;
+}
+
+static void map_locate_input(const char *path, mapped_file *map) {
+    if (!map_file(path, map)) {
+        fprintf(stderr, "Cant open / map locate input: %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void print_run(FILE *out, const options *option, int addr_width, size_t hay, size_t needle, size_t len) {
+    if (option->color) {
+        fprintf(out, "%s%0*zX %s| %s%0*zX %s| %s%10zu%s\n",
+                ADDR_COLOR, addr_width, hay, BORDER_COLOR,
+                ADDR_COLOR, addr_width, needle, BORDER_COLOR,
+                ANALYSIS_TEXT_COLOR, len, RESET);
+    } else {
+        fprintf(out, "%0*zX | %0*zX | %10zu\n", addr_width, hay, addr_width, needle, len);
+    }
+}
+
+void print_locate(options *option) {
+    FILE *out = stdout;
+    mapped_file needle, haystack;
+
+    map_locate_input(option->locate_needle, &needle);
+    map_locate_input(option->filename, &haystack);
+
+    size_t block = needle.size < LOCATE_BLOCK_SIZE ? needle.size : LOCATE_BLOCK_SIZE;
+    if (block < LOCATE_MIN_BLOCK) {
+        fprintf(stderr, "Error: needle must be at least %d bytes\n", LOCATE_MIN_BLOCK);
+        exit(EXIT_FAILURE);
+    }
+
+    size_t start = option->offset_read;
+    size_t end = get_read_end(option);
+    if (end == 0 || end > haystack.size) end = haystack.size;
+    if (start > end) start = end;
+
+    locate_job *job = calloc(1, sizeof(locate_job));
+    if (!job) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Index the needle blocks, the table is kept at most half full.
+    size_t block_count = needle.size / block;
+    size_t slot_count = 64;
+    while (slot_count < block_count * 2) slot_count *= 2;
+
+    job->slots = calloc(slot_count, sizeof(locate_slot));
+    if (!job->slots) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    job->slot_mask = slot_count - 1;
+    job->needle = needle.data;
+    job->haystack = haystack.data;
+    job->block = block;
+
+    size_t indexed = 0, fill_blocks = 0;
+    for (size_t blk = 0; blk < block_count; blk++) {
+        const unsigned char *data = needle.data + blk * block;
+        if (is_fill_block(data, block)) {
+            fill_blocks++;
+            continue;
+        }
+
+        uint64_t hash = block_hash(data, block);
+        size_t slot = slot_of(hash, job->slot_mask);
+        bool duplicate = false;
+
+        for (; job->slots[slot].offset; slot = (slot + 1) & job->slot_mask) {
+            if (job->slots[slot].hash == hash &&
+                memcmp(needle.data + job->slots[slot].offset - 1, data, block) == 0) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (duplicate) continue;
+
+        job->slots[slot].hash = hash;
+        job->slots[slot].offset = blk * block + 1;
+        indexed++;
+
+        uint64_t bit = hash >> (64 - LOCATE_FILTER_SHIFT);
+        job->filter[bit >> 6] |= 1ULL << (bit & 63);
+    }
+
+    uint64_t power = 1;
+    for (size_t i = 0; i < block; i++) power *= LOCATE_HASH_PRIME;
+    for (int b = 0; b < 256; b++) job->out_table[b] = (uint64_t)b * power;
+
+    // One pass over the haystack, one segment per worker.
+    job->start = start;
+    job->last = end - start >= block ? end - block + 1 : start;
+
+    size_t positions = job->last - job->start;
+    int workers = get_worker_count();
+    size_t segments = positions / (1 << 20) + 1;
+    if ((size_t)workers > segments) workers = (int)segments;
+    if (indexed > 0 && positions > 0) run_workers(locate_worker, job, workers);
+
+    if (option->pager) out = open_pager();
+
+    int addr_width = _hex_digits_size_t(end > needle.size ? end : needle.size);
+    if (addr_width < 8) addr_width = 8;
+    int row_width = addr_width + 3 + addr_width + 3 + 10;
+
+    if (option->color) fprintf(out, "%s", HEADER_COLOR);
+    fprintf(out, "\nlocate %s in %s (block %zu B):\n", option->locate_needle, option->filename, block);
+    fprintf(out, "%-*s | %-*s | %10s\n", addr_width, "haystack", addr_width, "needle", "length");
+    if (option->color) fprintf(out, "%s", BORDER_COLOR);
+    for (int i = 0; i < row_width; i++) fputc('-', out);
+    if (option->color) fprintf(out, "%s", RESET);
+    fputc('\n', out);
+
+    unsigned char *seen = calloc(block_count > 0 ? block_count : 1, 1);
+    if (!seen) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    match_list all = {0};
+    merge_segments(job, workers, &all);
+
+    size_t runs = 0;
+    size_t run_hay = 0, run_needle = 0, run_len = 0;
+
+    for (size_t i = 0; i < all.count; i++) {
+        locate_match m = all.items[i];
+        seen[m.needle / block] = 1;
+
+        if (run_len > 0 && m.haystack == run_hay + run_len && m.needle == run_needle + run_len) {
+            run_len += block;
+            continue;
+        }
+
+        if (run_len > 0) print_run(out, option, addr_width, run_hay, run_needle, run_len);
+        run_hay = m.haystack;
+        run_needle = m.needle;
+        run_len = block;
+        runs++;
+    }
+    if (run_len > 0) print_run(out, option, addr_width, run_hay, run_needle, run_len);
+
+    size_t found_blocks = 0;
+    for (size_t blk = 0; blk < block_count; blk++) found_blocks += seen[blk];
+
+    if (option->color) fprintf(out, "%s", BORDER_COLOR);
+    for (int i = 0; i < row_width; i++) fputc('-', out);
+    if (option->color) fprintf(out, "%s", RESET);
+    fputc('\n', out);
+
+    print_report_row(out, option, "locate", "matches %zu ; runs %zu ; needle blocks found %zu of %zu indexed",
+                     all.count, runs, found_blocks, indexed);
+    print_report_row(out, option, "needle", "size %zu B ; blocks %zu ; fill skipped %zu ; duplicates %zu ; tail %zu B",
+                     needle.size, block_count, fill_blocks, block_count - fill_blocks - indexed, needle.size % block);
+    print_report_row(out, option, "view", "haystack %zu B ; offset %zu ; workers %d", end - start, start, workers);
+    fputc('\n', out);
+
+    free(all.items);
+    free(seen);
+    free(job->slots);
+    free(job);
+    unmap_file(&needle);
+    unmap_file(&haystack);
+    if (option->pager) pclose(out);
+}
@@ -7,6 +7,9 @@
 
 #include "MagicBytes.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 static const uint8_t sig_0000[] = { 0x4D, 0x5A };
 static const uint8_t sig_0001[] = { 0x7F, 0x45, 0x4C, 0x46 };
 static const uint8_t sig_0002[] = { 0xCF, 0xFA, 0xED, 0xFE };
@@ -276,4 +279,73 @@ const MagicSignature Magic_Signatures[126] = {
     { sig_0072, 5, 32769, "iso", "ISO-9660 CD-ROM Image" },  // 43 44 30 30 31  offset 32769  iso
 };
 
-const int Magic_Signatures_Count = 126;
\ No newline at end of file
+const int Magic_Signatures_Count = 126;
+
+// Signatures detected in the header of the current input. Written once before
+// rendering, so the render path itself stays free of shared state.
+static int found_magic[256] = {0};
+
+// Counts how many magic byte signatures have been found in the file header, 
+// which can be used to display a summary of detected file types.
+int count_found_magic(void) {
+    int found_count = 0;
+
+    for (int sig_id = 0; sig_id < Magic_Signatures_Count; sig_id++) {
+        if (found_magic[sig_id] == 1) found_count++;
+    }
+
+    return found_count;
+}
+
+// Copies the detected signatures out / back in, so the sidecar cache can skip the header scan.
+void get_found_magic(unsigned char flags[256]) {
+    for (int sig_id = 0; sig_id < 256; sig_id++) flags[sig_id] = (unsigned char)found_magic[sig_id];
+}
+
+void set_found_magic(const unsigned char flags[256]) {
+    for (int sig_id = 0; sig_id < 256; sig_id++) found_magic[sig_id] = flags[sig_id] ? 1 : 0;
+}
+
+bool magic_found(int sig_id) {
+    return sig_id >= 0 && sig_id < 256 && found_magic[sig_id] == 1;
+}
+
+void reset_found_magic(void) {
+    memset(found_magic, 0, sizeof(found_magic));
+}
+
+// Reads the first part of the file and checks for known magic byte signatures in the header,
+// updating the found_magic to indicate which signatures were detected.
+void find_magic_bytes_in_stream_header(FILE *file) {
+    if (file == NULL || file == stdin) return;
+
+    fseek(file, 0, SEEK_END);
+    size_t file_size = (size_t)ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    if (file_size == 0) return;
+
+    enum { READ_PREFIX_SIZE = 65536 };
+    size_t to_read = (file_size < READ_PREFIX_SIZE) ? file_size : READ_PREFIX_SIZE;
+    unsigned char *magic_buffer = malloc(to_read);
+    if (!magic_buffer) {
+        perror("Malloc failed for file header");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t bytes_read = fread(magic_buffer, 1, to_read, file);
+
+    for (int sig_id = 0; sig_id < Magic_Signatures_Count; sig_id++) {
+        const MagicSignature *sig = &Magic_Signatures[sig_id];
+
+        if (sig->offset + sig->len > file_size || sig->offset + sig->len > bytes_read) {
+            continue;
+        }
+
+        if (memcmp(magic_buffer + sig->offset, sig->bytes, sig->len) == 0) {
+            found_magic[sig_id] = 1;
+        }
+    }
+
+    free(magic_buffer);
+}
@@ -0,0 +1,608 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+/* Built-in pager for -p on a terminal.
+ * How it works:
+ * - The file is memory mapped, nothing is rendered up front. Line n of the read range
+ *   starts at offset + n * width, so every position is computed, never scanned for.
+ * - Each frame renders only the visible lines with render_line() into one text buffer,
+ *   which goes to the terminal in a single write. The next screens are hinted to the
+ *   kernel (madvise WILLNEED) so scrolling down does not wait for the disk.
+ * - Jumps to an offset, to the start or the end cost the same as scrolling one line.
+ * - Search (the -se pattern, or ASCII / x:hex typed at the / prompt) scans the mapping
+ *   from the current position to the next or previous match only.
+ * - Memory use and latency depend on the terminal size, not on the file size.
+ * - Used when stdout is a terminal and the input is a regular file; otherwise -p pipes
+ *   the dump into less as before.
+ */
+
+#include "Pager.h"
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "DisplayUtils.h"
+#include "File.h"
+#include "Sink.h"
+#include "Utils.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+// The Windows console has no termios, -p keeps using the external pager there.
+bool pager_available(const options *option) {
+    (void)option;
+    return false;
+}
+
+void run_pager(options *option) {
+    (void)option;
+}
+
+#else
+
+enum {
+    KEY_NONE = 1000,
+    KEY_ESC,
+    KEY_UP,
+    KEY_DOWN,
+    KEY_PAGE_UP,
+    KEY_PAGE_DOWN,
+    KEY_HOME,
+    KEY_END,
+    KEY_RESIZE,
+    KEY_QUIT
+};
+
+typedef struct {
+    options *option;
+    mapped_file map;
+    output_sink sink;
+    size_t start;               // Read range [start, end) of the mapping
+    size_t end;
+    size_t width;
+    size_t line_count;
+    size_t top;                 // First visible line
+    int rows;
+    int cols;
+    int text_rows;              // Dump lines per screen
+    bool show_header;
+    display_state state;
+    text_buffer frame;
+    unsigned char *pattern;
+    size_t pattern_len;
+    size_t match;               // Offset of the last match, SIZE_MAX = none
+    char magic[256];
+    char message[PAGER_PROMPT_SIZE * 2];
+    int tty;
+} pager;
+
+static struct termios saved_termios;
+static bool termios_saved = false;
+static volatile sig_atomic_t resized = 0;
+static volatile sig_atomic_t terminated = 0;
+
+static void on_resize(int sig) {
+    (void)sig;
+    resized = 1;
+}
+
+static void on_terminate(int sig) {
+    (void)sig;
+    terminated = 1;
+}
+
+// Leaves the alternate screen and restores the terminal, also when hxed exits on an error.
+static void restore_terminal(void) {
+    if (!termios_saved) return;
+    termios_saved = false;
+
+    const char *leave = "\x1b[?25h\x1b[?1049l";
+    ssize_t ignored = write(STDOUT_FILENO, leave, strlen(leave));
+    (void)ignored;
+    tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved_termios);
+}
+
+// -p on a terminal with a regular file; streams, reverse mode and --raw -w 0 keep the
+// external pager.
+bool pager_available(const options *option) {
+    if (!option->pager || option->pipeline || option->reverse_mode || option->range_count > 0) return false;
+    if (option->buff_size <= 0) return false;
+    return isatty(STDOUT_FILENO) && isatty(STDIN_FILENO);
+}
+
+static bool enter_terminal(pager *p) {
+    if (tcgetattr(STDIN_FILENO, &saved_termios) != 0) return false;
+
+    struct termios raw = saved_termios;
+    raw.c_lflag &= ~(tcflag_t)(ICANON | ECHO | ISIG | IEXTEN);
+    raw.c_iflag &= ~(tcflag_t)(IXON | ICRNL);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) != 0) return false;
+
+    termios_saved = true;
+    atexit(restore_terminal);
+
+    // No SA_RESTART: a resize or SIGTERM interrupts the blocking read of the next key.
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sigemptyset(&sa.sa_mask);
+    sa.sa_handler = on_resize;
+    sigaction(SIGWINCH, &sa, NULL);
+    sa.sa_handler = on_terminate;
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGHUP, &sa, NULL);
+
+    p->tty = STDIN_FILENO;
+    const char *enter = "\x1b[?1049h\x1b[?25l";
+    ssize_t ignored = write(STDOUT_FILENO, enter, strlen(enter));
+    (void)ignored;
+    return true;
+}
+
+// Lines wider than the terminal wrap, so they take several rows each.
+static void update_layout(pager *p) {
+    struct winsize ws;
+    p->rows = 24;
+    p->cols = 80;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0 && ws.ws_col > 0) {
+        p->rows = ws.ws_row;
+        p->cols = ws.ws_col;
+    }
+
+    int row_width = calc_row_width(p->option, p->state.addr_width, p->state.visible_columns);
+    int line_height = row_width > p->cols ? (row_width + p->cols - 1) / p->cols : 1;
+    int available = p->rows - 1 - (p->show_header ? line_height : 0);
+
+    p->text_rows = available / line_height;
+    if (p->text_rows < 1) p->text_rows = 1;
+}
+
+static size_t max_top(const pager *p) {
+    return p->line_count > (size_t)p->text_rows ? p->line_count - (size_t)p->text_rows : 0;
+}
+
+static void scroll_to(pager *p, size_t line) {
+    size_t last = max_top(p);
+    p->top = line > last ? last : line;
+}
+
+static void scroll_by(pager *p, long delta) {
+    if (delta < 0 && (size_t)(-delta) > p->top) scroll_to(p, 0);
+    else scroll_to(p, p->top + (size_t)delta);
+}
+
+static size_t line_addr(const pager *p, size_t line) {
+    return p->start + line * p->width;
+}
+
+static void append_text(pager *p, const char *fmt, ...) {
+    char chunk[MAX_LINE_SIZE];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(chunk, sizeof(chunk), fmt, args);
+    va_end(args);
+
+    if (len <= 0) return;
+    if ((size_t)len >= sizeof(chunk)) len = (int)sizeof(chunk) - 1;
+    text_buffer_append(&p->frame, chunk, (size_t)len);
+}
+
+// Column header, the same row print_header() shows above the dump.
+static void append_header(pager *p) {
+    char header_line[MAX_LINE_SIZE] = {0};
+    size_t header_pos = 0;
+    const options *option = p->option;
+
+    append_to_line(header_line, sizeof(header_line), &header_pos, "%-*s | ", p->state.addr_width, "offset");
+    append_header_columns(header_line, sizeof(header_line), &header_pos, option, p->state.visible_columns);
+    if (option->ascii) append_to_line(header_line, sizeof(header_line), &header_pos, "| ascii");
+
+    append_text(p, "%s%s%s\n", option->color ? HEADER_COLOR : "", header_line, option->color ? RESET : "");
+}
+
+// Status row in reverse video, cut to the terminal width.
+static void append_status(pager *p, const char *text) {
+    char row[PAGER_PROMPT_SIZE * 4];
+    snprintf(row, sizeof(row), "%s", text);
+    if ((int)strlen(row) > p->cols) row[p->cols] = '\0';
+
+    append_text(p, "\x1b[%d;1H\x1b[7m%-*s\x1b[0m", p->rows, p->cols, row);
+}
+
+// Hints the kernel to read the screens below the viewport ahead of time.
+static void prefetch(const pager *p, size_t addr) {
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0 || addr >= p->end) return;
+
+    size_t len = (size_t)p->text_rows * p->width * PAGER_PREFETCH_SCREENS;
+    if (len > p->end - addr) len = p->end - addr;
+
+    size_t aligned = addr - addr % (size_t)page;
+    madvise((void *)(p->map.data + aligned), len + (addr - aligned), MADV_WILLNEED);
+}
+
+static void draw(pager *p) {
+    p->frame.len = 0;
+    append_text(p, "\x1b[H\x1b[J");
+    if (p->show_header) append_header(p);
+
+    size_t line = p->top;
+    for (int row = 0; row < p->text_rows && line < p->line_count; row++, line++) {
+        size_t addr = line_addr(p, line);
+        size_t len = p->end - addr < p->width ? p->end - addr : p->width;
+
+        p->state.data = p->map.data + addr;
+        p->state.addr_display = addr;
+        render_line(&p->state, 0, (int)len);
+    }
+
+    char status[PAGER_PROMPT_SIZE * 4];
+    if (p->message[0]) {
+        snprintf(status, sizeof(status), " %s", p->message);
+        p->message[0] = '\0';
+    } else {
+        size_t first = line_addr(p, p->top);
+        size_t last = line < p->line_count ? line_addr(p, line) : p->end;
+        size_t span = p->end - p->start;
+        int pct = span ? (int)((double)(last - p->start) * 100.0 / (double)span) : 100;
+        snprintf(status, sizeof(status), " %s  0x%zx-0x%zx of 0x%zx  %d%%%s%s  q quit  g/G  : offset  / search  n/N",
+                 p->option->filename, first, last, p->end, pct,
+                 p->magic[0] ? "  " : "", p->magic);
+    }
+    append_status(p, status);
+
+    text_buffer *frame = &p->frame;
+    sink_writev(&p->sink, &frame, 1);
+    prefetch(p, line_addr(p, line < p->line_count ? line : p->line_count));
+}
+
+// Reads one key, decoding the escape sequences of arrow, page and home/end keys.
+static int read_key(pager *p) {
+    unsigned char c;
+    ssize_t got = read(p->tty, &c, 1);
+    if (got < 0 && errno == EINTR) {
+        if (terminated) return KEY_QUIT;
+        if (resized) {
+            resized = 0;
+            return KEY_RESIZE;
+        }
+        return KEY_NONE;
+    }
+    if (got <= 0) return KEY_QUIT;
+    if (c != 0x1b) return c;
+
+    struct pollfd pfd = {.fd = p->tty, .events = POLLIN};
+    if (poll(&pfd, 1, PAGER_ESC_TIMEOUT_MS) <= 0) return KEY_ESC;
+
+    unsigned char seq[3] = {0};
+    if (read(p->tty, &seq[0], 1) != 1) return KEY_ESC;
+    if (seq[0] != '[' && seq[0] != 'O') return KEY_ESC;
+    if (read(p->tty, &seq[1], 1) != 1) return KEY_ESC;
+
+    switch (seq[1]) {
+        case 'A': return KEY_UP;
+        case 'B': return KEY_DOWN;
+        case 'H': return KEY_HOME;
+        case 'F': return KEY_END;
+        default: break;
+    }
+
+    if (seq[1] >= '0' && seq[1] <= '9') {
+        if (read(p->tty, &seq[2], 1) != 1 || seq[2] != '~') return KEY_NONE;
+        switch (seq[1]) {
+            case '1': case '7': return KEY_HOME;
+            case '4': case '8': return KEY_END;
+            case '5': return KEY_PAGE_UP;
+            case '6': return KEY_PAGE_DOWN;
+            default: break;
+        }
+    }
+    return KEY_NONE;
+}
+
+// Reads a line at the status row. Returns false when the prompt was cancelled.
+static bool prompt(pager *p, const char *label, char *input, size_t input_size) {
+    size_t len = 0;
+    input[0] = '\0';
+
+    while (1) {
+        char status[PAGER_PROMPT_SIZE * 4];
+        snprintf(status, sizeof(status), "%s%s", label, input);
+
+        p->frame.len = 0;
+        append_status(p, status);
+        append_text(p, "\x1b[%d;%dH\x1b[?25h", p->rows, (int)strlen(status) + 1);
+        text_buffer *frame = &p->frame;
+        sink_writev(&p->sink, &frame, 1);
+
+        int key = read_key(p);
+        if (key == KEY_RESIZE) {
+            update_layout(p);
+            scroll_to(p, p->top);
+            draw(p);
+            continue;
+        }
+
+        bool done = key == '\r' || key == '\n';
+        bool cancel = key == KEY_ESC || key == KEY_QUIT || key == 3;
+        if (done || cancel) {
+            const char *hide = "\x1b[?25l";
+            p->frame.len = 0;
+            text_buffer_append(&p->frame, hide, strlen(hide));
+            sink_writev(&p->sink, &frame, 1);
+            return done && len > 0;
+        }
+
+        if ((key == 127 || key == 8) && len > 0) input[--len] = '\0';
+        else if (key < 256 && isprint(key) && len + 1 < input_size) {
+            input[len++] = (char)key;
+            input[len] = '\0';
+        }
+    }
+}
+
+// Offset prompt: decimal or 0x hex, absolute within the file.
+static void goto_offset(pager *p) {
+    char input[PAGER_PROMPT_SIZE];
+    if (!prompt(p, "offset: ", input, sizeof(input))) return;
+
+    char *end = NULL;
+    errno = 0;
+    unsigned long long value = strtoull(input, &end, 0);
+    if (errno != 0 || end == input || *end != '\0') {
+        snprintf(p->message, sizeof(p->message), "invalid offset <%s>", input);
+        return;
+    }
+    if (value < p->start || value >= p->end) {
+        snprintf(p->message, sizeof(p->message), "offset 0x%llx is outside 0x%zx-0x%zx", value, p->start, p->end);
+        return;
+    }
+
+    scroll_to(p, ((size_t)value - p->start) / p->width);
+}
+
+// Search prompt: ASCII text, or x: followed by hex digits.
+static void set_pattern(pager *p) {
+    char input[PAGER_PROMPT_SIZE];
+    if (!prompt(p, "search: ", input, sizeof(input))) return;
+
+    unsigned char bytes[PAGER_PROMPT_SIZE];
+    size_t len = 0;
+
+    if (strncmp(input, "x:", 2) == 0) {
+        const char *hex = input + 2;
+        size_t hex_len = strlen(hex);
+        for (size_t i = 0; i < hex_len; i += 2) {
+            char pair[3] = {hex[i], hex[i + 1], '\0'};
+            char *end = NULL;
+            if (!isxdigit((unsigned char)pair[0]) || !isxdigit((unsigned char)pair[1])) {
+                snprintf(p->message, sizeof(p->message), "invalid hex pattern <%s>", input);
+                return;
+            }
+            bytes[len++] = (unsigned char)strtoul(pair, &end, 16);
+        }
+    } else {
+        const char *text = strncmp(input, "a:", 2) == 0 ? input + 2 : input;
+        len = strlen(text);
+        memcpy(bytes, text, len);
+    }
+
+    if (len == 0) return;
+
+    unsigned char *pattern = realloc(p->pattern, len);
+    if (!pattern) {
+        perror("Malloc failed for search pattern");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(pattern, bytes, len);
+    p->pattern = pattern;
+    p->pattern_len = len;
+    p->match = SIZE_MAX;
+}
+
+static size_t find_forward(const pager *p, size_t from) {
+    if (p->pattern_len == 0 || p->end - p->start < p->pattern_len) return SIZE_MAX;
+    size_t last = p->end - p->pattern_len;
+
+    while (from <= last) {
+        const unsigned char *hit = memchr(p->map.data + from, p->pattern[0], last - from + 1);
+        if (!hit) return SIZE_MAX;
+
+        size_t pos = (size_t)(hit - p->map.data);
+        if (memcmp(hit, p->pattern, p->pattern_len) == 0) return pos;
+        from = pos + 1;
+    }
+    return SIZE_MAX;
+}
+
+static size_t find_backward(const pager *p, size_t from) {
+    if (p->pattern_len == 0 || p->end - p->start < p->pattern_len) return SIZE_MAX;
+    size_t last = p->end - p->pattern_len;
+    if (from > last) from = last;
+
+    for (size_t pos = from + 1; pos-- > p->start;) {
+        if (p->map.data[pos] == p->pattern[0] && memcmp(p->map.data + pos, p->pattern, p->pattern_len) == 0) return pos;
+    }
+    return SIZE_MAX;
+}
+
+// Moves to the next (or previous) match, relative to the last match while it is on screen.
+static void search_next(pager *p, bool backward) {
+    if (p->pattern_len == 0) {
+        snprintf(p->message, sizeof(p->message), "no search pattern, press / to enter one");
+        return;
+    }
+
+    size_t view_start = line_addr(p, p->top);
+    size_t view_end = line_addr(p, p->top + (size_t)p->text_rows);
+    bool on_screen = p->match != SIZE_MAX && p->match >= view_start && p->match < view_end;
+
+    size_t pos;
+    if (backward) {
+        size_t from = on_screen ? p->match : view_start;
+        pos = from > p->start ? find_backward(p, from - 1) : SIZE_MAX;
+    } else {
+        pos = find_forward(p, on_screen ? p->match + 1 : view_start);
+    }
+
+    if (pos == SIZE_MAX) {
+        snprintf(p->message, sizeof(p->message), "pattern not found %s", backward ? "before this screen" : "after this screen");
+        return;
+    }
+
+    p->match = pos;
+    scroll_to(p, (pos - p->start) / p->width);
+    snprintf(p->message, sizeof(p->message), "match at 0x%zx", pos);
+}
+
+static void init_pager(pager *p, options *option) {
+    memset(p, 0, sizeof(*p));
+    p->option = option;
+    p->match = SIZE_MAX;
+    p->width = (size_t)option->buff_size;
+    p->show_header = !option->raw && !option->skip_header;
+
+    // Every screen row is one computed line, skipped or squeezed lines would leave gaps.
+    option->skip_zero = false;
+    option->squeeze = false;
+
+    if (!map_file(option->filename, &p->map)) {
+        fprintf(stderr, "Error: could not map <%s>\n", option->filename);
+        exit(EXIT_FAILURE);
+    }
+    if (p->map.size > 0) madvise((void *)p->map.data, p->map.size, MADV_RANDOM);
+
+    p->start = option->offset_read;
+    p->end = get_read_end(option);
+    if (p->end == 0 || p->end > p->map.size) p->end = p->map.size;
+    if (p->start > p->end) p->start = p->end;
+    p->line_count = (p->end - p->start + p->width - 1) / p->width;
+
+    sink_stdout(&p->sink);
+
+    p->state.out = stdout;
+    p->state.option = option;
+    p->state.capture = &p->frame;
+    p->state.addr_width = 8;
+    p->state.visible_columns = _calc_visible_columns(option);
+    int needed_digits = _hex_digits_size_t(p->end);
+    if (needed_digits > p->state.addr_width) p->state.addr_width = needed_digits;
+
+    // Same magic detection as the dump, it only reads the file header.
+    reset_display_utils_state();
+    if (!option->skip_header && p->start == 0) {
+        FILE *file = fopen(option->filename, "rb");
+        if (file) {
+            find_magic_bytes_in_stream_header(file);
+            fclose(file);
+            size_t magic_pos = 0;
+            if (count_found_magic() > 0) append_magic_summary(p->magic, sizeof(p->magic), &magic_pos);
+        }
+    }
+
+    if (option->search_len > 0) {
+        p->pattern = malloc(option->search_len);
+        if (!p->pattern) {
+            perror("Malloc failed for search pattern");
+            exit(EXIT_FAILURE);
+        }
+        memcpy(p->pattern, option->search, option->search_len);
+        p->pattern_len = option->search_len;
+    }
+}
+
+void run_pager(options *option) {
+    pager p;
+    init_pager(&p, option);
+
+    if (!enter_terminal(&p)) {
+        fprintf(stderr, "Error: could not set up the terminal for the pager\n");
+        exit(EXIT_FAILURE);
+    }
+
+    update_layout(&p);
+    if (p.pattern_len > 0) search_next(&p, false);
+
+    bool running = true;
+    while (running) {
+        draw(&p);
+
+        int key = read_key(&p);
+        long page = p.text_rows > 1 ? p.text_rows - 1 : 1;
+
+        switch (key) {
+            case 'q': case 'Q': case KEY_ESC: case KEY_QUIT: case 3:
+                running = false;
+                break;
+            case 'j': case '\r': case '\n': case KEY_DOWN:
+                scroll_by(&p, 1);
+                break;
+            case 'k': case KEY_UP:
+                scroll_by(&p, -1);
+                break;
+            case ' ': case 'f': case KEY_PAGE_DOWN:
+                scroll_by(&p, page);
+                break;
+            case 'b': case KEY_PAGE_UP:
+                scroll_by(&p, -page);
+                break;
+            case 'd':
+                scroll_by(&p, page / 2 > 0 ? page / 2 : 1);
+                break;
+            case 'u':
+                scroll_by(&p, -(page / 2 > 0 ? page / 2 : 1));
+                break;
+            case 'g': case '<': case KEY_HOME:
+                scroll_to(&p, 0);
+                break;
+            case 'G': case '>': case KEY_END:
+                scroll_to(&p, max_top(&p));
+                break;
+            case ':': case 'o':
+                goto_offset(&p);
+                break;
+            case '/':
+                set_pattern(&p);
+                if (p.pattern_len > 0) search_next(&p, false);
+                break;
+            case 'n':
+                search_next(&p, false);
+                break;
+            case 'N':
+                search_next(&p, true);
+                break;
+            case KEY_RESIZE:
+                update_layout(&p);
+                scroll_to(&p, p.top);
+                break;
+            default:
+                break;
+        }
+    }
+
+    restore_terminal();
+    free(p.frame.data);
+    free(p.pattern);
+    unmap_file(&p.map);
+}
+
+#endif
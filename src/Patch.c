@@ -0,0 +1,542 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+/* Binary delta patches (--make-patch A B, --apply-patch P A).
+ * Patch layout (little endian):
+ *   "HXPATCH1", u64 source size, u64 target size, u64 source XXH64, u64 target XXH64,
+ *   then COPY / INSERT operations and a final END tag.
+ * How a patch is made:
+ * - The source is cut into content-defined chunks (Gear / FastCDC) in parallel, one
+ *   segment per worker, and every chunk digest is put into an index.
+ * - Each worker then chunks its own segment of the target and looks the chunks up.
+ *   A verified hit is extended backwards and forwards byte by byte, so matches are not
+ *   limited to chunk boundaries; everything else becomes literal insert data.
+ * - The per-segment operation lists are concatenated and written in target order.
+ * Applying streams the patch and the source (seek + read per copy), so neither file
+ * has to fit into memory. Both digests are checked.
+ */
+
+#include "Patch.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Dedup.h"
+#include "DisplayUtils.h"
+#include "File.h"
+#include "Hash.h"
+#include "Threads.h"
+#include "Utils.h"
+
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+    #define isatty _isatty
+    #define fileno _fileno
+#else
+    #include <unistd.h>
+#endif
+
+#define PATCH_IO_SIZE (1 << 20)
+
+typedef struct {
+    char kind;              // PATCH_OP_COPY or PATCH_OP_INSERT
+    size_t src;             // Source offset (copy) or target offset (insert)
+    size_t len;
+} patch_op;
+
+typedef struct {
+    patch_op *ops;
+    size_t count;
+    size_t cap;
+} op_list;
+
+// One source anchor.
+typedef struct {
+    uint64_t digest;
+    size_t offset;
+} anchor_entry;
+
+typedef struct {
+    const unsigned char *src;
+    size_t src_size;
+    const unsigned char *dst;
+    size_t dst_size;
+    cdc_params params;
+    int workers;
+
+    // Source chunking, one list per worker.
+    anchor_entry *chunks[MAX_WORKERS];
+    size_t chunk_count[MAX_WORKERS];
+
+    // Index: digest -> first source offset with that chunk (open addressing).
+    anchor_entry *slots;
+    size_t slot_mask;
+
+    // Matching, one operation list per target segment.
+    op_list lists[MAX_WORKERS];
+
+    uint64_t src_digest;
+    uint64_t dst_digest;
+} patch_job;
+
+static void push_op(op_list *list, char kind, size_t src, size_t len) {
+    if (len == 0) return;
+
+    // Extend the previous operation where possible.
+    if (list->count > 0) {
+        patch_op *last = &list->ops[list->count - 1];
+        if (last->kind == kind && kind == PATCH_OP_INSERT && last->src + last->len == src) {
+            last->len += len;
+            return;
+        }
+        if (last->kind == kind && kind == PATCH_OP_COPY && last->src + last->len == src) {
+            last->len += len;
+            return;
+        }
+    }
+
+    if (list->count == list->cap) {
+        size_t new_cap = list->cap ? list->cap * 2 : 1024;
+        patch_op *tmp = realloc(list->ops, new_cap * sizeof(patch_op));
+        if (!tmp) {
+            perror("Malloc failed for patch operations");
+            exit(EXIT_FAILURE);
+        }
+        list->ops = tmp;
+        list->cap = new_cap;
+    }
+
+    list->ops[list->count].kind = kind;
+    list->ops[list->count].src = src;
+    list->ops[list->count].len = len;
+    list->count++;
+}
+
+// Part [first, last) of a buffer handled by one worker.
+static void segment_bounds(size_t size, int worker_id, int worker_count, size_t *first, size_t *last) {
+    *first = size * (size_t)worker_id / (size_t)worker_count;
+    *last = size * (size_t)(worker_id + 1) / (size_t)worker_count;
+}
+
+// Worker: chunks one source segment. The last worker computes both whole-file digests.
+static void source_worker(void *ctx, int worker_id, int worker_count) {
+    patch_job *job = (patch_job *)ctx;
+
+    if (worker_id == worker_count - 1) {
+        job->src_digest = xxh64(job->src, job->src_size, 0);
+        job->dst_digest = xxh64(job->dst, job->dst_size, 0);
+        return;
+    }
+
+    size_t pos, end;
+    segment_bounds(job->src_size, worker_id, worker_count - 1, &pos, &end);
+
+    size_t cap = (end - pos) / job->params.min_size + 2;
+    anchor_entry *chunks = malloc(cap * sizeof(anchor_entry));
+    if (!chunks) {
+        perror("Malloc failed for patch anchors");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t count = 0;
+    while (pos < end) {
+        size_t len = cdc_next_cut(&job->params, job->src + pos, end - pos, true);
+
+        // Only full sized chunks are indexed; a short segment tail rarely matches.
+        if (len >= job->params.min_size) {
+            chunks[count].digest = xxh64(job->src + pos, len, 0);
+            chunks[count].offset = pos;
+            count++;
+        }
+        pos += len;
+    }
+
+    job->chunks[worker_id] = chunks;
+    job->chunk_count[worker_id] = count;
+}
+
+static void build_index(patch_job *job) {
+    size_t total = 0;
+    for (int w = 0; w < job->workers; w++) total += job->chunk_count[w];
+
+    size_t slot_count = 1024;
+    while (slot_count < total * 2) slot_count <<= 1;
+
+    job->slots = malloc(slot_count * sizeof(anchor_entry));
+    if (!job->slots) {
+        perror("Malloc failed for patch index");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < slot_count; i++) job->slots[i].offset = (size_t)-1;
+    job->slot_mask = slot_count - 1;
+
+    for (int w = 0; w < job->workers; w++) {
+        for (size_t i = 0; i < job->chunk_count[w]; i++) {
+            const anchor_entry *chunk = &job->chunks[w][i];
+            size_t slot = (size_t)chunk->digest & job->slot_mask;
+
+            while (job->slots[slot].offset != (size_t)-1 && job->slots[slot].digest != chunk->digest) {
+                slot = (slot + 1) & job->slot_mask;
+            }
+            if (job->slots[slot].offset == (size_t)-1) job->slots[slot] = *chunk;
+        }
+        free(job->chunks[w]);
+        job->chunks[w] = NULL;
+    }
+}
+
+static size_t index_lookup(const patch_job *job, uint64_t digest) {
+    size_t slot = (size_t)digest & job->slot_mask;
+    while (job->slots[slot].offset != (size_t)-1) {
+        if (job->slots[slot].digest == digest) return job->slots[slot].offset;
+        slot = (slot + 1) & job->slot_mask;
+    }
+    return (size_t)-1;
+}
+
+// Number of equal leading bytes, compared a word at a time.
+static size_t match_forward(const unsigned char *a, const unsigned char *b, size_t max) {
+    size_t n = 0;
+
+    while (n + 8 <= max) {
+        uint64_t wa, wb;
+        memcpy(&wa, a + n, 8);
+        memcpy(&wb, b + n, 8);
+        if (wa != wb) break;
+        n += 8;
+    }
+
+    while (n < max && a[n] == b[n]) n++;
+    return n;
+}
+
+// Worker: matches one target segment against the source index.
+static void target_worker(void *ctx, int worker_id, int worker_count) {
+    patch_job *job = (patch_job *)ctx;
+    op_list *list = &job->lists[worker_id];
+    const unsigned char *src = job->src;
+    const unsigned char *dst = job->dst;
+
+    size_t pos, end;
+    segment_bounds(job->dst_size, worker_id, worker_count, &pos, &end);
+
+    size_t literal = pos;           // Start of the pending insert data
+    size_t expect_src = 0;          // Source offset that would continue the last copy
+    size_t expect_dst = 0;
+    bool have_expect = false;
+
+    while (pos < end) {
+        size_t len = cdc_next_cut(&job->params, dst + pos, end - pos, true);
+        size_t hit = (size_t)-1;
+
+        // In-place edits keep the source and target in step, try that position first.
+        if (have_expect) {
+            size_t guess = expect_src + (pos - expect_dst);
+            if (guess + len <= job->src_size && memcmp(src + guess, dst + pos, len) == 0) hit = guess;
+        }
+
+        if (hit == (size_t)-1 && len >= job->params.min_size) {
+            size_t found = index_lookup(job, xxh64(dst + pos, len, 0));
+            if (found != (size_t)-1 && found + len <= job->src_size && memcmp(src + found, dst + pos, len) == 0) {
+                hit = found;
+            }
+        }
+
+        if (hit == (size_t)-1) {
+            pos += len;
+            continue;
+        }
+
+        // Grow the match in both directions.
+        size_t s = hit, d = pos;
+        while (d > literal && s > 0 && src[s - 1] == dst[d - 1]) {
+            s--;
+            d--;
+        }
+
+        size_t stop = pos + len;
+        size_t src_left = job->src_size - (hit + len);
+        size_t dst_left = end - stop;
+        stop += match_forward(src + hit + len, dst + stop, src_left < dst_left ? src_left : dst_left);
+
+        push_op(list, PATCH_OP_INSERT, literal, d - literal);
+        push_op(list, PATCH_OP_COPY, s, stop - d);
+
+        expect_src = s + (stop - d);
+        expect_dst = stop;
+        have_expect = true;
+        pos = stop;
+        literal = stop;
+    }
+
+    push_op(list, PATCH_OP_INSERT, literal, end - literal);
+}
+
+static void patch_error(const char *message) {
+    fprintf(stderr, "Error: %s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+// A short write means the patch or the patched file is truncated, which must not exit 0.
+static void write_failed(void) {
+    char message[256];
+    snprintf(message, sizeof(message), "writing the output failed: %s", strerror(errno ? errno : EIO));
+    patch_error(message);
+}
+
+static void write_bytes(FILE *out, const void *data, size_t len) {
+    if (len > 0 && fwrite(data, 1, len, out) != len) write_failed();
+}
+
+static void write_u64(FILE *out, uint64_t value) {
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; i++) bytes[i] = (unsigned char)(value >> (i * 8));
+    write_bytes(out, bytes, 8);
+}
+
+static void write_varint(FILE *out, uint64_t value) {
+    unsigned char bytes[10];
+    size_t len = 0;
+    while (value >= 0x80) {
+        bytes[len++] = (unsigned char)((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    bytes[len++] = (unsigned char)value;
+    write_bytes(out, bytes, len);
+}
+
+static void write_tag(FILE *out, int tag) {
+    unsigned char byte = (unsigned char)tag;
+    write_bytes(out, &byte, 1);
+}
+
+// Everything buffered must have reached the output before it is reported as complete.
+static void finish_output(FILE *out) {
+    if (fflush(out) != 0 || ferror(out)) write_failed();
+}
+
+static uint64_t read_u64(FILE *in) {
+    unsigned char bytes[8];
+    if (fread(bytes, 1, 8, in) != 8) return 0;
+
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) value |= (uint64_t)bytes[i] << (i * 8);
+    return value;
+}
+
+static bool read_varint(FILE *in, uint64_t *value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = fgetc(in);
+        if (c == EOF) return false;
+        *value |= (uint64_t)(c & 0x7F) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+static void map_patch_input(const char *path, mapped_file *map) {
+    if (!map_file(path, map)) {
+        fprintf(stderr, "Cant open / map patch input: %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Binary output must not end up in a terminal, and Windows must not translate newlines.
+static void prepare_binary_stdout(void) {
+    if (isatty(fileno(stdout))) {
+        fprintf(stderr, "Error: refusing to write binary data to a terminal, redirect stdout\n");
+        exit(EXIT_FAILURE);
+    }
+
+    #ifdef _WIN32
+    _setmode(_fileno(stdout), _O_BINARY);
+    #endif
+    setvbuf(stdout, NULL, _IOFBF, PATCH_IO_SIZE);
+}
+
+void make_patch(options *option) {
+    mapped_file map_src, map_dst;
+    map_patch_input(option->filename, &map_src);
+    map_patch_input(option->make_patch, &map_dst);
+    prepare_binary_stdout();
+
+    patch_job *job = calloc(1, sizeof(patch_job));
+    if (!job) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    job->src = map_src.data;
+    job->src_size = map_src.size;
+    job->dst = map_dst.data;
+    job->dst_size = map_dst.size;
+
+    size_t avg = PATCH_CHUNK_AVG;
+    while (job->src_size / avg > PATCH_MAX_ANCHORS && avg < 262144) avg *= 2;
+    cdc_init(&job->params, avg);
+
+    // Source: one worker per segment plus one for the digests.
+    int workers = get_worker_count();
+    size_t segments = job->src_size / PATCH_MIN_SEGMENT + 1;
+    if ((size_t)workers > segments) workers = (int)segments;
+    if (workers > MAX_WORKERS - 1) workers = MAX_WORKERS - 1;
+    job->workers = workers;
+    run_workers(source_worker, job, workers + 1);
+    build_index(job);
+
+    // Target: one segment per worker, matched against the shared index.
+    int match_workers = get_worker_count();
+    segments = job->dst_size / PATCH_MIN_SEGMENT + 1;
+    if ((size_t)match_workers > segments) match_workers = (int)segments;
+    run_workers(target_worker, job, match_workers);
+
+    write_bytes(stdout, PATCH_MAGIC, 8);
+    write_u64(stdout, job->src_size);
+    write_u64(stdout, job->dst_size);
+    write_u64(stdout, job->src_digest);
+    write_u64(stdout, job->dst_digest);
+
+    size_t copies = 0, inserts = 0, copied = 0, literal = 0;
+    size_t next_src = 0;
+
+    for (int w = 0; w < match_workers; w++) {
+        op_list *list = &job->lists[w];
+
+        for (size_t i = 0; i < list->count; i++) {
+            const patch_op *op = &list->ops[i];
+
+            if (op->kind == PATCH_OP_COPY) {
+                int64_t delta = (int64_t)op->src - (int64_t)next_src;
+                write_tag(stdout, PATCH_OP_COPY);
+                write_varint(stdout, ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+                write_varint(stdout, op->len);
+                next_src = op->src + op->len;
+                copies++;
+                copied += op->len;
+            } else {
+                write_tag(stdout, PATCH_OP_INSERT);
+                write_varint(stdout, op->len);
+                write_bytes(stdout, job->dst + op->src, op->len);
+                inserts++;
+                literal += op->len;
+            }
+        }
+        free(list->ops);
+    }
+
+    write_tag(stdout, PATCH_OP_END);
+    finish_output(stdout);
+
+    if (!option->skip_header) {
+        print_report_row(stderr, option, "patch", "copy %zu (%zu B) ; insert %zu (%zu B) ; anchors avg %zu B ; workers %d",
+                         copies, copied, inserts, literal, job->params.avg_size, match_workers);
+    }
+
+    free(job->slots);
+    free(job);
+    unmap_file(&map_src);
+    unmap_file(&map_dst);
+}
+
+void apply_patch(options *option) {
+    FILE *patch = fopen(option->apply_patch, "rb");
+    FILE *source = fopen(option->filename, "rb");
+    unsigned char *io = malloc(PATCH_IO_SIZE);
+
+    if (!patch || !source) {
+        perror("Cant open patch / source file");
+        exit(EXIT_FAILURE);
+    }
+    if (!io) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    char magic[8];
+    if (fread(magic, 1, 8, patch) != 8 || memcmp(magic, PATCH_MAGIC, 8) != 0) {
+        patch_error("not an hxed patch");
+    }
+
+    uint64_t src_size = read_u64(patch);
+    uint64_t dst_size = read_u64(patch);
+    uint64_t src_digest = read_u64(patch);
+    uint64_t dst_digest = read_u64(patch);
+
+    // Verify the source before writing anything.
+    xxh64_state state;
+    xxh64_init(&state, 0);
+    uint64_t seen = 0;
+    size_t got;
+    while ((got = fread(io, 1, PATCH_IO_SIZE, source)) > 0) {
+        xxh64_update(&state, io, got);
+        seen += got;
+    }
+    if (seen != src_size || xxh64_digest(&state) != src_digest) {
+        patch_error("source file does not match the patch");
+    }
+
+    prepare_binary_stdout();
+    xxh64_init(&state, 0);
+
+    uint64_t written = 0;
+    uint64_t next_src = 0;
+
+    while (1) {
+        int tag = fgetc(patch);
+        uint64_t len;
+
+        if (tag == PATCH_OP_END) break;
+
+        if (tag == PATCH_OP_COPY) {
+            uint64_t zigzag;
+            if (!read_varint(patch, &zigzag) || !read_varint(patch, &len)) patch_error("truncated patch");
+
+            int64_t delta = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+            uint64_t offset = next_src + (uint64_t)delta;
+            if (offset > src_size || len > src_size - offset) patch_error("corrupt patch (copy out of range)");
+
+            file_seek(source, (size_t)offset);
+            next_src = offset + len;
+
+            while (len > 0) {
+                size_t step = len < PATCH_IO_SIZE ? (size_t)len : PATCH_IO_SIZE;
+                if (fread(io, 1, step, source) != step) patch_error("source file changed while patching");
+                write_bytes(stdout, io, step);
+                xxh64_update(&state, io, step);
+                written += step;
+                len -= step;
+            }
+        } else if (tag == PATCH_OP_INSERT) {
+            if (!read_varint(patch, &len)) patch_error("truncated patch");
+
+            while (len > 0) {
+                size_t step = len < PATCH_IO_SIZE ? (size_t)len : PATCH_IO_SIZE;
+                if (fread(io, 1, step, patch) != step) patch_error("truncated patch");
+                write_bytes(stdout, io, step);
+                xxh64_update(&state, io, step);
+                written += step;
+                len -= step;
+            }
+        } else {
+            patch_error("corrupt patch (unknown operation)");
+        }
+    }
+
+    finish_output(stdout);
+    if (written != dst_size || xxh64_digest(&state) != dst_digest) {
+        patch_error("patched output does not match the expected target");
+    }
+
+    free(io);
+    fclose(source);
+    fclose(patch);
+}
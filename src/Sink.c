@@ -0,0 +1,215 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+/* Output sinks for the rendered dump.
+ * How it works:
+ * - A sink is where the writer thread puts the rendered text: a file descriptor,
+ *   a stdio stream or the pager.
+ * - fd and pager sinks bypass stdio. All buffers that are queued at once go out in a
+ *   single writev call (up to SINK_MAX_IOV), partial writes and EINTR are retried.
+ * - The stdio stream of the sink still carries header and footer rows; it is flushed
+ *   before the first raw write so the order on the fd stays intact.
+ * - SIGPIPE is ignored once stdout or the pager is used as a sink: a reader that went
+ *   away shows up as EPIPE from the writer thread, so the dump can stop and clean up
+ *   instead of being killed mid-write. Pipes are also polled for a closed reading end,
+ *   which catches a quit pager while no output is being written.
+ */
+
+#include "Sink.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Utils.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <poll.h>
+#include <signal.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+void sink_from_fd(output_sink *sink, int fd, FILE *stream) {
+    memset(sink, 0, sizeof(*sink));
+    sink->kind = SINK_FD;
+    sink->fd = fd;
+    sink->stream = stream;
+}
+
+void sink_from_file(output_sink *sink, FILE *stream) {
+    memset(sink, 0, sizeof(*sink));
+    sink->kind = SINK_FILE;
+    sink->fd = -1;
+    sink->stream = stream;
+}
+
+static void ignore_sigpipe(void) {
+    #ifndef _WIN32
+    signal(SIGPIPE, SIG_IGN);
+    #endif
+}
+
+// Standard output, written with writev where the platform has it.
+void sink_stdout(output_sink *sink) {
+    ignore_sigpipe();
+    #ifdef _WIN32
+    sink_from_file(sink, stdout);
+    #else
+    sink_from_fd(sink, STDOUT_FILENO, stdout);
+    #endif
+}
+
+// Pipe into less/more. Falls back to standard output when no pager could be started.
+void sink_open_pager(output_sink *sink) {
+    FILE *pager = open_pager();
+    if (pager == stdout) {
+        sink_stdout(sink);
+        return;
+    }
+
+    ignore_sigpipe();
+    memset(sink, 0, sizeof(*sink));
+    sink->kind = SINK_PAGER;
+    sink->fd = fileno(pager);
+    sink->stream = pager;
+}
+
+// Writes len bytes to fd, retrying short writes. Returns 0 or errno.
+static int write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        #ifdef _WIN32
+        unsigned int part = len > 0x40000000u ? 0x40000000u : (unsigned int)len;
+        int written = _write(fd, data, part);
+        #else
+        ssize_t written = write(fd, data, len);
+        #endif
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return errno ? errno : EIO;
+        }
+        data += written;
+        len -= (size_t)written;
+    }
+    return 0;
+}
+
+#ifndef _WIN32
+// One writev for up to SINK_MAX_IOV buffers, continuing after partial writes.
+static int writev_all(int fd, text_buffer *const *bufs, size_t count) {
+    struct iovec iov[SINK_MAX_IOV];
+    int iov_count = 0;
+    for (size_t i = 0; i < count && iov_count < SINK_MAX_IOV; i++) {
+        if (bufs[i]->len == 0) continue;
+        iov[iov_count].iov_base = bufs[i]->data;
+        iov[iov_count].iov_len = bufs[i]->len;
+        iov_count++;
+    }
+
+    struct iovec *cur = iov;
+    while (iov_count > 0) {
+        ssize_t written = writev(fd, cur, iov_count);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return errno ? errno : EIO;
+        }
+
+        // Skip fully written buffers, trim the first partially written one.
+        while (iov_count > 0 && (size_t)written >= cur->iov_len) {
+            written -= (ssize_t)cur->iov_len;
+            cur++;
+            iov_count--;
+        }
+        if (iov_count > 0) {
+            cur->iov_base = (char *)cur->iov_base + written;
+            cur->iov_len -= (size_t)written;
+        }
+    }
+    return 0;
+}
+#endif
+
+// Writes count buffers in order. Returns 0 or the errno of the failed write.
+int sink_writev(output_sink *sink, text_buffer *const *bufs, size_t count) {
+    switch (sink->kind) {
+        case SINK_FILE:
+            for (size_t i = 0; i < count; i++) {
+                if (bufs[i]->len > 0 && fwrite(bufs[i]->data, 1, bufs[i]->len, sink->stream) != bufs[i]->len) {
+                    return errno ? errno : EIO;
+                }
+            }
+            return 0;
+
+        case SINK_FD:
+        case SINK_PAGER:
+            #ifdef _WIN32
+            for (size_t i = 0; i < count; i++) {
+                int error = write_all(sink->fd, bufs[i]->data, bufs[i]->len);
+                if (error) return error;
+            }
+            return 0;
+            #else
+            for (size_t i = 0; i < count; i += SINK_MAX_IOV) {
+                size_t part = count - i < SINK_MAX_IOV ? count - i : SINK_MAX_IOV;
+                int error = part == 1 ? write_all(sink->fd, bufs[i]->data, bufs[i]->len)
+                                      : writev_all(sink->fd, bufs + i, part);
+                if (error) return error;
+            }
+            return 0;
+            #endif
+    }
+    return 0;
+}
+
+// True for the error of a write into a pipe nobody reads anymore.
+bool sink_reader_gone(int error) {
+    #ifdef _WIN32
+    return error == EPIPE || error == EINVAL;
+    #else
+    return error == EPIPE;
+    #endif
+}
+
+// Checks without blocking whether the reading end of a pipe sink was closed. Needed when
+// little output is produced (e.g. -se), so the next failing write could be far away.
+bool sink_reader_closed(output_sink *sink) {
+    #ifdef _WIN32
+    (void)sink;
+    return false;
+    #else
+    if (sink->kind != SINK_FD && sink->kind != SINK_PAGER) return false;
+
+    struct pollfd pfd = {.fd = sink->fd, .events = POLLOUT};
+    if (poll(&pfd, 1, 0) <= 0) return false;
+    return (pfd.revents & (POLLERR | POLLHUP)) != 0;
+    #endif
+}
+
+// Exit status for a failed write. A closed pipe means the reader is done (pager quit, head
+// got its lines): stop quietly. Any other failed write is an error.
+int sink_exit_status(int error) {
+    if (sink_reader_gone(error)) return EXIT_SUCCESS;
+
+    fprintf(stderr, "Write error: %s\n", strerror(error));
+    return EXIT_FAILURE;
+}
+
+// Flushes text written to the stream, so raw writes land behind it.
+int sink_flush(output_sink *sink) {
+    if (sink->stream && fflush(sink->stream) != 0) return errno ? errno : EIO;
+    return 0;
+}
+
+// Flushes and closes the sink; the pager is waited for. Returns 0 or errno.
+int sink_close(output_sink *sink) {
+    int error = sink_flush(sink);
+    if (sink->kind == SINK_PAGER) pclose(sink->stream);
+    sink->stream = NULL;
+    return error;
+}
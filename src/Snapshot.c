@@ -0,0 +1,396 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+/* Merkle-tree snapshots (--snapshot OUT, --since SNAP).
+ * Snapshot layout (little endian):
+ *   "HXSNAP01", u64 block size, u64 file size, u64 leaf count, u64 level count,
+ *   then the digests of every level, leaves first and the root last.
+ * How it works:
+ * - The whole file is cut into SNAPSHOT_BLOCK_SIZE leaves, hashed with XXH64 in parallel.
+ * - A parent is the XXH64 of its (one or two) child digests, up to a single root.
+ * - --since hashes the file again and descends both trees from the root. Equal nodes
+ *   are skipped with all their leaves, so an unchanged file costs one comparison and
+ *   a few local edits cost O(changes * depth).
+ * - Lines of the read range that touch a changed leaf are rendered with render_line.
+ */
+
+#include "Snapshot.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "DisplayUtils.h"
+#include "File.h"
+#include "Hash.h"
+#include "Threads.h"
+#include "Utils.h"
+
+#define SNAPSHOT_READ_SIZE (1 << 20)    // Read size per worker call, a multiple of the leaf size
+
+typedef struct {
+    size_t file_size;
+    int level_count;
+    size_t level_size[SNAPSHOT_MAX_LEVELS];
+    uint64_t *levels[SNAPSHOT_MAX_LEVELS];  // levels[0] = leaves, levels[level_count - 1] = root
+} merkle_tree;
+
+// Shared state for the leaf workers.
+typedef struct {
+    const char *filename;
+    size_t file_size;
+    size_t leaf_count;
+    uint64_t *leaves;
+} leaf_job;
+
+static void leaf_worker(void *ctx, int worker_id, int worker_count) {
+    leaf_job *job = (leaf_job *)ctx;
+    size_t first = job->leaf_count * (size_t)worker_id / (size_t)worker_count;
+    size_t last = job->leaf_count * (size_t)(worker_id + 1) / (size_t)worker_count;
+    if (first >= last) return;
+
+    FILE *file = fopen(job->filename, "rb");
+    unsigned char *chunk = malloc(SNAPSHOT_READ_SIZE);
+    if (!file || !chunk) {
+        perror("Snapshot worker failed");
+        exit(EXIT_FAILURE);
+    }
+
+    file_seek(file, first * (size_t)SNAPSHOT_BLOCK_SIZE);
+
+    size_t per_read = SNAPSHOT_READ_SIZE / SNAPSHOT_BLOCK_SIZE;
+    for (size_t leaf = first; leaf < last; leaf += per_read) {
+        size_t count = last - leaf < per_read ? last - leaf : per_read;
+        size_t pos = leaf * (size_t)SNAPSHOT_BLOCK_SIZE;
+        size_t want = count * (size_t)SNAPSHOT_BLOCK_SIZE;
+        if (want > job->file_size - pos) want = job->file_size - pos;
+
+        size_t got = fread(chunk, 1, want, file);
+
+        // A file that shrank while hashing just gets digests of the bytes still there.
+        for (size_t i = 0; i < count; i++) {
+            size_t off = i * (size_t)SNAPSHOT_BLOCK_SIZE;
+            size_t len = off < got ? got - off : 0;
+            if (len > SNAPSHOT_BLOCK_SIZE) len = SNAPSHOT_BLOCK_SIZE;
+            job->leaves[leaf + i] = xxh64(chunk + off, len, 0);
+        }
+    }
+
+    free(chunk);
+    fclose(file);
+}
+
+static void *alloc_or_die(size_t count, size_t size) {
+    void *ptr = calloc(count > 0 ? count : 1, size);
+    if (!ptr) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
+}
+
+// Hashes all leaves of the file in parallel and builds the levels above them.
+static void build_tree(merkle_tree *tree, const char *filename, size_t file_size, int *workers_used) {
+    memset(tree, 0, sizeof(*tree));
+    tree->file_size = file_size;
+
+    size_t leaf_count = (file_size + SNAPSHOT_BLOCK_SIZE - 1) / SNAPSHOT_BLOCK_SIZE;
+    leaf_job job = {filename, file_size, leaf_count, alloc_or_die(leaf_count, sizeof(uint64_t))};
+
+    int workers = get_worker_count();
+    size_t reads = (leaf_count + SNAPSHOT_READ_SIZE / SNAPSHOT_BLOCK_SIZE - 1) / (SNAPSHOT_READ_SIZE / SNAPSHOT_BLOCK_SIZE);
+    if ((size_t)workers > reads) workers = reads > 0 ? (int)reads : 1;
+    if (leaf_count > 0) run_workers(leaf_worker, &job, workers);
+    if (workers_used) *workers_used = workers;
+
+    tree->levels[0] = job.leaves;
+    tree->level_size[0] = leaf_count;
+    tree->level_count = 1;
+
+    // Parents hash the little endian bytes of their children, so snapshots are portable.
+    while (tree->level_size[tree->level_count - 1] > 1) {
+        int level = tree->level_count;
+        size_t below = tree->level_size[level - 1];
+        size_t count = (below + 1) / 2;
+
+        tree->levels[level] = alloc_or_die(count, sizeof(uint64_t));
+        tree->level_size[level] = count;
+
+        for (size_t i = 0; i < count; i++) {
+            unsigned char bytes[16];
+            size_t children = 2 * i + 1 < below ? 2 : 1;
+
+            for (size_t c = 0; c < children; c++) {
+                uint64_t digest = tree->levels[level - 1][2 * i + c];
+                for (int b = 0; b < 8; b++) bytes[c * 8 + b] = (unsigned char)(digest >> (b * 8));
+            }
+            tree->levels[level][i] = xxh64(bytes, children * 8, 0);
+        }
+        tree->level_count++;
+    }
+}
+
+static void free_tree(merkle_tree *tree) {
+    for (int level = 0; level < tree->level_count; level++) free(tree->levels[level]);
+    tree->level_count = 0;
+}
+
+static uint64_t tree_root(const merkle_tree *tree) {
+    return tree->level_size[0] ? tree->levels[tree->level_count - 1][0] : 0;
+}
+
+static void write_u64(FILE *out, uint64_t value) {
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; i++) bytes[i] = (unsigned char)(value >> (i * 8));
+    fwrite(bytes, 1, 8, out);
+}
+
+static bool read_u64(FILE *in, uint64_t *value) {
+    unsigned char bytes[8];
+    if (fread(bytes, 1, 8, in) != 8) return false;
+
+    *value = 0;
+    for (int i = 0; i < 8; i++) *value |= (uint64_t)bytes[i] << (i * 8);
+    return true;
+}
+
+static void snapshot_error(const char *path, const char *message) {
+    fprintf(stderr, "Error: %s: %s\n", path, message);
+    exit(EXIT_FAILURE);
+}
+
+static void save_tree(const merkle_tree *tree, const char *path) {
+    FILE *out = fopen(path, "wb");
+    if (!out) snapshot_error(path, "cannot create snapshot");
+
+    fwrite(SNAPSHOT_MAGIC, 1, 8, out);
+    write_u64(out, SNAPSHOT_BLOCK_SIZE);
+    write_u64(out, tree->file_size);
+    write_u64(out, tree->level_size[0]);
+    write_u64(out, (uint64_t)tree->level_count);
+
+    for (int level = 0; level < tree->level_count; level++) {
+        for (size_t i = 0; i < tree->level_size[level]; i++) write_u64(out, tree->levels[level][i]);
+    }
+
+    if (ferror(out) | fclose(out)) snapshot_error(path, "write failed");
+}
+
+static void load_tree(merkle_tree *tree, const char *path) {
+    FILE *in = fopen(path, "rb");
+    if (!in) snapshot_error(path, "cannot open snapshot");
+
+    char magic[8];
+    uint64_t block_size, file_size, leaf_count, level_count;
+    if (fread(magic, 1, 8, in) != 8 || memcmp(magic, SNAPSHOT_MAGIC, 8) != 0 ||
+        !read_u64(in, &block_size) || !read_u64(in, &file_size) ||
+        !read_u64(in, &leaf_count) || !read_u64(in, &level_count)) {
+        snapshot_error(path, "not a snapshot");
+    }
+
+    if (block_size != SNAPSHOT_BLOCK_SIZE || level_count == 0 || level_count > SNAPSHOT_MAX_LEVELS ||
+        leaf_count != (file_size + SNAPSHOT_BLOCK_SIZE - 1) / SNAPSHOT_BLOCK_SIZE) {
+        snapshot_error(path, "unsupported or damaged snapshot");
+    }
+
+    memset(tree, 0, sizeof(*tree));
+    tree->file_size = (size_t)file_size;
+
+    size_t count = (size_t)leaf_count;
+    for (int level = 0; level < (int)level_count; level++) {
+        tree->levels[level] = alloc_or_die(count, sizeof(uint64_t));
+        tree->level_size[level] = count;
+        tree->level_count++;
+
+        for (size_t i = 0; i < count; i++) {
+            if (!read_u64(in, &tree->levels[level][i])) snapshot_error(path, "truncated snapshot");
+        }
+        count = (count + 1) / 2;
+    }
+
+    fclose(in);
+}
+
+// --snapshot: hashes the whole file and writes the tree.
+void write_snapshot(options *option) {
+    FILE *out = stdout;
+    file_metadata meta;
+    if (!get_file_metadata(option->filename, &meta)) {
+        perror("File not found / No permission to read");
+        exit(EXIT_FAILURE);
+    }
+
+    merkle_tree tree;
+    int workers = 1;
+    build_tree(&tree, option->filename, meta.file_size, &workers);
+    save_tree(&tree, option->snapshot_out);
+
+    if (option->color) fprintf(out, "%s", HEADER_COLOR);
+    fprintf(out, "\nsnapshot of %s -> %s:\n", option->filename, option->snapshot_out);
+    if (option->color) fprintf(out, "%s", RESET);
+
+    print_report_row(out, option, "tree", "blocks %zu of %d B ; levels %d ; root %016llx",
+                     tree.level_size[0], SNAPSHOT_BLOCK_SIZE, tree.level_count,
+                     (unsigned long long)tree_root(&tree));
+    print_report_row(out, option, "view", "size %zu B ; workers %d", tree.file_size, workers);
+    fputc('\n', out);
+
+    free_tree(&tree);
+}
+
+// Marks the leaves below (level, idx) whose digest differs from the old tree.
+// Node idx at a level covers the same leaves in both trees, whatever their sizes.
+static void descend(const merkle_tree *old, const merkle_tree *now, int level, size_t idx,
+                    unsigned char *changed, size_t *visited) {
+    if (idx >= now->level_size[level]) return;
+    (*visited)++;
+
+    bool in_old = level < old->level_count && idx < old->level_size[level];
+    if (in_old && old->levels[level][idx] == now->levels[level][idx]) return;
+
+    if (level == 0) {
+        changed[idx] = 1;
+        return;
+    }
+
+    descend(old, now, level - 1, 2 * idx, changed, visited);
+    descend(old, now, level - 1, 2 * idx + 1, changed, visited);
+}
+
+// Renders the lines of [from, to) through the regular dump path.
+static void render_range(display_state *state, FILE *file, unsigned char *display_buffer, size_t from, size_t to) {
+    size_t width = (size_t)state->option->buff_size;
+    size_t chunk = MAX_BUFF_SIZE / width * width;
+
+    file_seek(file, from);
+    state->addr_display = from;
+
+    while (from < to) {
+        size_t want = to - from < chunk ? to - from : chunk;
+        size_t got = fread(display_buffer, 1, want, file);
+        if (got == 0) break;
+
+        for (size_t processed = 0; processed < got; processed += width) {
+            size_t line_len = got - processed < width ? got - processed : width;
+            render_line(state, (int)processed, (int)line_len);
+            state->addr_display += line_len;
+        }
+        from += got;
+    }
+}
+
+// --since: compares the file against a snapshot and prints only the changed lines.
+void print_since(options *option) {
+    FILE *out = stdout;
+    file_metadata meta;
+    if (!get_file_metadata(option->filename, &meta)) {
+        perror("File not found / No permission to read");
+        exit(EXIT_FAILURE);
+    }
+
+    merkle_tree old, now;
+    int workers = 1;
+    load_tree(&old, option->since_snapshot);
+    build_tree(&now, option->filename, meta.file_size, &workers);
+
+    unsigned char *changed = alloc_or_die(now.level_size[0], 1);
+    size_t visited = 0;
+    if (now.level_size[0] > 0) descend(&old, &now, now.level_count - 1, 0, changed, &visited);
+
+    size_t start = option->offset_read;
+    size_t end = get_read_end(option);
+    if (end == 0 || end > now.file_size) end = now.file_size;
+    size_t width = (size_t)option->buff_size;
+
+    if (option->pager) out = open_pager();
+    reset_display_utils_state();
+
+    unsigned char *display_buffer = alloc_or_die(MAX_BUFF_SIZE, 1);
+    display_state state = {0};
+    state.out = out;
+    state.option = option;
+    state.data = display_buffer;
+    state.addr_width = _hex_digits_size_t(end);
+    if (state.addr_width < 8) state.addr_width = 8;
+    state.visible_columns = _calc_visible_columns(option);
+
+    bool show_frame = !option->raw && !option->skip_header;
+    int row_width = calc_row_width(option, state.addr_width, state.visible_columns);
+
+    if (show_frame) {
+        if (option->color) fprintf(out, "%s", HEADER_COLOR);
+        fprintf(out, "\nchanges in %s since %s:\n", option->filename, option->since_snapshot);
+        if (option->color) fprintf(out, "%s", BORDER_COLOR);
+        for (int i = 0; i < row_width; i++) fputc('-', out);
+        if (option->color) fprintf(out, "%s", RESET);
+        fputc('\n', out);
+    }
+
+    FILE *file = fopen(option->filename, "rb");
+    if (!file) {
+        perror("File not found / No permission to read");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t changed_blocks = 0, ranges = 0, rendered_to = start;
+    for (size_t leaf = 0; leaf < now.level_size[0];) {
+        if (!changed[leaf]) {
+            leaf++;
+            continue;
+        }
+
+        size_t run = leaf;
+        while (run < now.level_size[0] && changed[run]) run++;
+        changed_blocks += run - leaf;
+
+        size_t from = leaf * (size_t)SNAPSHOT_BLOCK_SIZE;
+        size_t to = run * (size_t)SNAPSHOT_BLOCK_SIZE;
+        if (to > now.file_size) to = now.file_size;
+        leaf = run;
+
+        // Clamp to the read range and widen to whole lines of the dump.
+        if (from < start) from = start;
+        if (to > end) to = end;
+        if (from >= to) continue;
+
+        from = start + (from - start) / width * width;
+        to = start + (to - start + width - 1) / width * width;
+        if (to > end) to = end;
+        if (from < rendered_to) from = rendered_to;
+        if (from >= to) continue;
+
+        ranges++;
+        if (show_frame) print_report_row(out, option, "changed", "offset %zu ; len %zu", from, to - from);
+        render_range(&state, file, display_buffer, from, to);
+        rendered_to = to;
+    }
+    fclose(file);
+
+    if (show_frame) {
+        if (option->color) fprintf(out, "%s", BORDER_COLOR);
+        for (int i = 0; i < row_width; i++) fputc('-', out);
+        if (option->color) fprintf(out, "%s", RESET);
+        fputc('\n', out);
+
+        print_report_row(out, option, "since", "changed %zu of %zu blocks ; ranges %zu ; nodes visited %zu",
+                         changed_blocks, now.level_size[0], ranges, visited);
+        if (old.file_size != now.file_size) {
+            print_report_row(out, option, "size", "%zu -> %zu B", old.file_size, now.file_size);
+        }
+        print_report_row(out, option, "view", "block %d B ; offset %zu ; limit %zu ; workers %d",
+                         SNAPSHOT_BLOCK_SIZE, start, end, workers);
+        fputc('\n', out);
+    }
+
+    free(display_buffer);
+    free(changed);
+    free_tree(&old);
+    free_tree(&now);
+    if (option->pager) pclose(out);
+}
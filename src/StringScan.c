@@ -0,0 +1,396 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+/* Native strings extraction (--strings).
+ * How it works:
+ * - Each 64 byte block is turned into two bit masks: printable bytes and zero bytes.
+ *   The masks are built 16 bytes at a time with SSE2 compares (scalar fallback elsewhere).
+ * - ASCII runs are the runs of set bits in the printable mask.
+ * - UTF-16LE units are "printable byte followed by a zero byte"; even and odd start
+ *   offsets are tracked separately, each as a run of every second bit.
+ * - Run state survives chunk boundaries, so strings spanning two reads are found too.
+ * - Finished strings are queued and written in offset order once no open run starts
+ *   before them. Runs of different kinds overlap by at most one byte, so only a string
+ *   longer than STRINGS_LINE_CAP is written in pieces, when it is the first one open.
+ */
+
+#include "StringScan.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "DisplayUtils.h"
+#include "File.h"
+#include "Utils.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define STRINGS_CHUNK_SIZE (1 << 20)
+
+// One open run of printable characters (ASCII or one UTF-16 alignment).
+typedef struct {
+    size_t start;                   // Absolute offset of the first character
+    size_t length;                  // Characters in the run so far
+    size_t buffered;                // Characters waiting in text
+    bool flushed;                   // Prefix already written (string longer than the line cap)
+    char text[STRINGS_LINE_CAP];
+} string_run;
+
+// A finished string waiting for the runs that started before it.
+typedef struct {
+    size_t start;
+    size_t text_pos;                // Offset of the characters in strings_ctx.pending_text
+    size_t text_len;
+    bool utf16;
+} pending_string;
+
+typedef struct {
+    FILE *out;
+    const options *option;
+    size_t min_len;
+    int addr_width;
+    size_t found_ascii;
+    size_t found_utf16;
+    string_run ascii;
+    string_run utf16[2];            // Indexed by parity of the absolute start offset
+    pending_string *pending;
+    size_t pending_count;
+    size_t pending_cap;
+    text_buffer pending_text;
+} strings_ctx;
+
+static inline int count_trailing_zeros(uint64_t value) {
+    #if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (int)index;
+    #else
+    return __builtin_ctzll(value);
+    #endif
+}
+
+// Length of the run of set bits starting at bit 0 (64 if all bits are set).
+static inline int count_trailing_ones(uint64_t value) {
+    return ~value == 0 ? 64 : count_trailing_zeros(~value);
+}
+
+static inline bool is_string_byte(unsigned char b) {
+    return (b >= 0x20 && b <= 0x7E) || b == '\t';
+}
+
+// Printable and zero masks for 64 bytes starting at data (bit i = byte i).
+static inline void classify_block(const unsigned char *data, uint64_t *printable, uint64_t *zero) {
+    #ifdef HXED_HAVE_SSE2
+    const __m128i low = _mm_set1_epi8(0x1F);
+    const __m128i high = _mm_set1_epi8(0x7F);
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i nul = _mm_setzero_si128();
+    uint64_t p = 0;
+    uint64_t z = 0;
+
+    for (int i = 0; i < 4; i++) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + i * 16));
+        // Bytes >= 0x80 are negative as signed chars, so (v > 0x1F) && (v < 0x7F) is 0x20..0x7E.
+        __m128i in_range = _mm_and_si128(_mm_cmpgt_epi8(v, low), _mm_cmplt_epi8(v, high));
+        __m128i is_print = _mm_or_si128(in_range, _mm_cmpeq_epi8(v, tab));
+
+        p |= (uint64_t)(uint16_t)_mm_movemask_epi8(is_print) << (i * 16);
+        z |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, nul)) << (i * 16);
+    }
+
+    *printable = p;
+    *zero = z;
+    #else
+    uint64_t p = 0;
+    uint64_t z = 0;
+    for (int i = 0; i < 64; i++) {
+        if (is_string_byte(data[i])) p |= (uint64_t)1 << i;
+        if (data[i] == 0) z |= (uint64_t)1 << i;
+    }
+    *printable = p;
+    *zero = z;
+    #endif
+}
+
+// Packs the even bits of value into the low 32 bits (bit 2k -> bit k).
+static inline uint64_t compress_even_bits(uint64_t value) {
+    value &= 0x5555555555555555ULL;
+    value = (value | (value >> 1)) & 0x3333333333333333ULL;
+    value = (value | (value >> 2)) & 0x0F0F0F0F0F0F0F0FULL;
+    value = (value | (value >> 4)) & 0x00FF00FF00FF00FFULL;
+    value = (value | (value >> 8)) & 0x0000FFFF0000FFFFULL;
+    value = (value | (value >> 16)) & 0x00000000FFFFFFFFULL;
+    return value;
+}
+
+static void write_run_prefix(strings_ctx *ctx, const string_run *run, bool utf16) {
+    if (ctx->option->raw) return;
+
+    if (ctx->option->color) {
+        fprintf(ctx->out, "%s%0*zX %s| %s%-5s %s| %s",
+                ADDR_COLOR, ctx->addr_width, run->start, BORDER_COLOR,
+                utf16 ? EXTENDED_ASCII_COLOR : CONTROL_COLOR, utf16 ? "utf16" : "ascii",
+                BORDER_COLOR, ASCII_COLOR);
+    } else {
+        fprintf(ctx->out, "%0*zX | %-5s | ", ctx->addr_width, run->start, utf16 ? "utf16" : "ascii");
+    }
+}
+
+static void write_run_end(strings_ctx *ctx, const char *text, size_t len) {
+    fwrite(text, 1, len, ctx->out);
+    if (ctx->option->color) fputs(RESET, ctx->out);
+    fputc('\n', ctx->out);
+}
+
+// Offset order; at the same offset ASCII comes first.
+static int compare_pending(const void *a, const void *b) {
+    const pending_string *x = a;
+    const pending_string *y = b;
+    if (x->start != y->start) return x->start < y->start ? -1 : 1;
+    return (int)x->utf16 - (int)y->utf16;
+}
+
+// Writes the queued strings that start before limit, in offset order.
+static void emit_pending(strings_ctx *ctx, size_t limit) {
+    if (ctx->pending_count == 0) return;
+
+    qsort(ctx->pending, ctx->pending_count, sizeof(pending_string), compare_pending);
+
+    size_t done = 0;
+    while (done < ctx->pending_count && ctx->pending[done].start < limit) {
+        const pending_string *str = &ctx->pending[done];
+        string_run prefix = {.start = str->start};
+
+        write_run_prefix(ctx, &prefix, str->utf16);
+        write_run_end(ctx, ctx->pending_text.data + str->text_pos, str->text_len);
+        done++;
+    }
+
+    ctx->pending_count -= done;
+    memmove(ctx->pending, ctx->pending + done, ctx->pending_count * sizeof(pending_string));
+    if (ctx->pending_count == 0) ctx->pending_text.len = 0;
+}
+
+// Start of the first open run; strings queued before it are final.
+static size_t open_runs_start(const strings_ctx *ctx) {
+    size_t first = SIZE_MAX;
+    if (ctx->ascii.length > 0 && ctx->ascii.start < first) first = ctx->ascii.start;
+    for (int i = 0; i < 2; i++) {
+        if (ctx->utf16[i].length > 0 && ctx->utf16[i].start < first) first = ctx->utf16[i].start;
+    }
+    return first;
+}
+
+static void queue_run(strings_ctx *ctx, const string_run *run, bool utf16) {
+    if (ctx->pending_count == ctx->pending_cap) {
+        size_t cap = ctx->pending_cap ? ctx->pending_cap * 2 : 256;
+        pending_string *grown = realloc(ctx->pending, cap * sizeof(pending_string));
+        if (!grown) {
+            perror("Malloc failed");
+            exit(EXIT_FAILURE);
+        }
+        ctx->pending = grown;
+        ctx->pending_cap = cap;
+    }
+
+    pending_string *str = &ctx->pending[ctx->pending_count++];
+    str->start = run->start;
+    str->text_pos = ctx->pending_text.len;
+    str->text_len = run->buffered;
+    str->utf16 = utf16;
+    text_buffer_append(&ctx->pending_text, run->text, run->buffered);
+}
+
+// Closes the run: queues it if it reached the minimum length, then resets it. A run
+// that is already partly written is the first one open, so its end goes out directly.
+static void end_run(strings_ctx *ctx, string_run *run, bool utf16) {
+    if (run->length >= ctx->min_len) {
+        if (run->flushed) write_run_end(ctx, run->text, run->buffered);
+        else queue_run(ctx, run, utf16);
+
+        if (utf16) ctx->found_utf16++;
+        else ctx->found_ascii++;
+    }
+
+    run->length = 0;
+    run->buffered = 0;
+    run->flushed = false;
+}
+
+// Appends count characters (every stride-th byte of src) to the run starting at abs_start.
+static void feed_run(strings_ctx *ctx, string_run *run, bool utf16, const unsigned char *src,
+                     size_t count, size_t stride, size_t abs_start) {
+    if (run->length == 0) run->start = abs_start;
+
+    while (count > 0) {
+        if (run->buffered == STRINGS_LINE_CAP) {
+            // Only strings already past the minimum can fill the buffer (min <= cap).
+            // Everything queued before it goes first.
+            if (!run->flushed) {
+                emit_pending(ctx, run->start + 1);
+                write_run_prefix(ctx, run, utf16);
+            }
+            fwrite(run->text, 1, run->buffered, ctx->out);
+            run->buffered = 0;
+            run->flushed = true;
+        }
+
+        size_t take = STRINGS_LINE_CAP - run->buffered;
+        if (take > count) take = count;
+
+        if (stride == 1) {
+            memcpy(run->text + run->buffered, src, take);
+        } else {
+            for (size_t i = 0; i < take; i++) run->text[run->buffered + i] = (char)src[i * stride];
+        }
+
+        run->buffered += take;
+        run->length += take;
+        src += take * stride;
+        count -= take;
+    }
+}
+
+// Walks the runs of set bits of mask[lo, hi) (unit positions), feeding or closing the run.
+// base points at unit 0, unit k is at base + k * stride, abs_base is its absolute offset.
+static void scan_mask(strings_ctx *ctx, string_run *run, bool utf16, uint64_t mask, int lo, int hi,
+                      const unsigned char *base, size_t stride, size_t abs_base) {
+    int pos = lo;
+
+    while (pos < hi) {
+        uint64_t rest = mask >> pos;
+        int n;
+
+        if (rest & 1) {
+            n = count_trailing_ones(rest);
+            if (n > hi - pos) n = hi - pos;
+            feed_run(ctx, run, utf16, base + (size_t)pos * stride, (size_t)n, stride, abs_base + (size_t)pos * stride);
+        } else {
+            n = rest == 0 ? 64 : count_trailing_zeros(rest);
+            if (n > hi - pos) n = hi - pos;
+            if (run->length > 0) end_run(ctx, run, utf16);
+        }
+
+        pos += n;
+    }
+}
+
+// Scans buf[0, len). buf[0] may be the last byte of the previous chunk (carry = 1): it was
+// already seen as ASCII but could not be checked as UTF-16 unit start without its successor.
+// UTF-16 units are scanned for starts [0, len - 1), the last byte is carried to the next call.
+static void scan_chunk(strings_ctx *ctx, const unsigned char *buf, size_t len, size_t carry, size_t abs_base) {
+    unsigned char tail[64 + 1];
+
+    for (size_t j = 0; j < len; j += 64) {
+        const unsigned char *block = buf + j;
+        size_t block_len = len - j < 64 ? len - j : 64;
+        bool full = j + 64 < len;   // Block and the byte after it are inside buf
+
+        // Copy the tail so the classifier can always load 64 (+1) bytes.
+        if (!full) {
+            memset(tail, 0xFF, sizeof(tail));
+            memcpy(tail, block, block_len);
+            block = tail;
+        }
+
+        uint64_t printable;
+        uint64_t zero;
+        classify_block(block, &printable, &zero);
+
+        // ASCII: bytes [carry, len).
+        int lo = j < carry ? (int)(carry - j) : 0;
+        scan_mask(ctx, &ctx->ascii, false, printable, lo, (int)block_len, block, 1, abs_base + j);
+
+        // UTF-16LE: unit starts [0, len - 1), unit at i needs byte i + 1 == 0.
+        int unit_hi = (int)block_len;
+        if (j + (size_t)unit_hi > len - 1) unit_hi = (int)(len - 1 - j);
+        if (unit_hi <= 0) continue;
+
+        uint64_t next_zero = full && block[64] == 0 ? 1 : 0;
+        uint64_t units = printable & ((zero >> 1) | (next_zero << 63));
+
+        for (int shift = 0; shift < 2; shift++) {
+            size_t abs_start = abs_base + j + (size_t)shift;
+            string_run *run = &ctx->utf16[abs_start & 1];
+            uint64_t lane = compress_even_bits(units >> shift);
+            int lane_hi = (unit_hi - shift + 1) / 2;
+            if (lane_hi <= 0) continue;
+
+            scan_mask(ctx, run, true, lane, 0, lane_hi, block + shift, 2, abs_start);
+        }
+    }
+}
+
+// --strings: print printable ASCII and UTF-16LE runs of at least min_len characters.
+void print_strings(options *option) {
+    FILE *file = open_input_file(option);
+    size_t start = option->offset_read;
+    size_t end = get_read_end(option);
+
+    strings_ctx *ctx = calloc(1, sizeof(strings_ctx));
+    unsigned char *buf = malloc(STRINGS_CHUNK_SIZE + 1);
+    if (!ctx || !buf) {
+        perror("Malloc failed");
+        exit(EXIT_FAILURE);
+    }
+
+    ctx->out = stdout;
+    ctx->option = option;
+    ctx->min_len = option->strings_min;
+    ctx->addr_width = _hex_digits_size_t(end);
+    if (ctx->addr_width < 8) ctx->addr_width = 8;
+
+    bool show_frame = !option->raw && !option->skip_header;
+
+    if (show_frame) {
+        if (option->color) fprintf(ctx->out, "%s", HEADER_COLOR);
+        fprintf(ctx->out, "\nstrings in %s (min %zu):\n", option->pipeline ? "<pipe>" : option->filename, ctx->min_len);
+        if (option->color) fprintf(ctx->out, "%s", RESET);
+    }
+
+    range_reader reader;
+    range_reader_init(&reader, file, option->pipeline, start, end);
+
+    size_t carry = 0;
+    size_t abs_base = start;
+    size_t got;
+
+    while ((got = range_reader_read(&reader, buf + carry, STRINGS_CHUNK_SIZE)) > 0) {
+        size_t len = carry + got;
+        scan_chunk(ctx, buf, len, carry, abs_base);
+        emit_pending(ctx, open_runs_start(ctx));
+
+        // Keep the last byte as the first UTF-16 candidate of the next chunk.
+        abs_base += len - 1;
+        buf[0] = buf[len - 1];
+        carry = 1;
+    }
+
+    if (ctx->ascii.length > 0) end_run(ctx, &ctx->ascii, false);
+    if (ctx->utf16[0].length > 0) end_run(ctx, &ctx->utf16[0], true);
+    if (ctx->utf16[1].length > 0) end_run(ctx, &ctx->utf16[1], true);
+    emit_pending(ctx, SIZE_MAX);
+
+    if (show_frame) {
+        fputc('\n', ctx->out);
+        print_report_row(ctx->out, option, "strings", "ascii %zu ; utf16 %zu ; min %zu",
+                         ctx->found_ascii, ctx->found_utf16, ctx->min_len);
+        print_report_row(ctx->out, option, "view", "offset %zu ; read %zu", start, reader.pos - start);
+        fputc('\n', ctx->out);
+    }
+
+    free(buf);
+    free(ctx->pending);
+    free(ctx->pending_text.data);
+    free(ctx);
+    if (!option->pipeline) fclose(file);
+}
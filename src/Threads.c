@@ -0,0 +1,103 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+#include "Threads.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+typedef struct {
+    worker_fn fn;
+    void *ctx;
+    int worker_id;
+    int worker_count;
+} worker_args;
+
+#ifdef _WIN32
+static DWORD WINAPI worker_main(LPVOID param) {
+    worker_args *args = (worker_args *)param;
+    args->fn(args->ctx, args->worker_id, args->worker_count);
+    return 0;
+}
+#else
+static void *worker_main(void *param) {
+    worker_args *args = (worker_args *)param;
+    args->fn(args->ctx, args->worker_id, args->worker_count);
+    return NULL;
+}
+#endif
+
+// Returns the number of online CPUs, clamped to [1, MAX_WORKERS].
+int get_worker_count(void) {
+    long count = 1;
+
+    #ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    count = (long)info.dwNumberOfProcessors;
+    #elif defined(_SC_NPROCESSORS_ONLN)
+    count = sysconf(_SC_NPROCESSORS_ONLN);
+    #endif
+
+    if (count < 1) count = 1;
+    if (count > MAX_WORKERS) count = MAX_WORKERS;
+    return (int)count;
+}
+
+// Runs fn on worker_count threads and waits for all of them. Worker 0 runs on the
+// calling thread, so a single worker never pays for a thread spawn.
+void run_workers(worker_fn fn, void *ctx, int worker_count) {
+    if (worker_count < 1) worker_count = 1;
+    if (worker_count > MAX_WORKERS) worker_count = MAX_WORKERS;
+
+    worker_args args[MAX_WORKERS];
+    for (int i = 0; i < worker_count; i++) {
+        args[i].fn = fn;
+        args[i].ctx = ctx;
+        args[i].worker_id = i;
+        args[i].worker_count = worker_count;
+    }
+
+    #ifdef _WIN32
+    HANDLE handles[MAX_WORKERS] = {0};
+    for (int i = 1; i < worker_count; i++) {
+        handles[i] = CreateThread(NULL, 0, worker_main, &args[i], 0, NULL);
+        if (!handles[i]) {
+            fprintf(stderr, "Error: could not start worker thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    fn(ctx, 0, worker_count);
+
+    for (int i = 1; i < worker_count; i++) {
+        WaitForSingleObject(handles[i], INFINITE);
+        CloseHandle(handles[i]);
+    }
+    #else
+    pthread_t threads[MAX_WORKERS];
+    for (int i = 1; i < worker_count; i++) {
+        if (pthread_create(&threads[i], NULL, worker_main, &args[i]) != 0) {
+            fprintf(stderr, "Error: could not start worker thread\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    fn(ctx, 0, worker_count);
+
+    for (int i = 1; i < worker_count; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    #endif
+}
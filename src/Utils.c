@@ -8,6 +8,7 @@
 #include "Utils.h"
 
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
 #ifdef _WIN32
@@ -149,25 +150,101 @@ bool get_file_metadata(const char *filename, file_metadata *meta) {
     #endif
 }
 
+// Byte class lookup for the scalar path: 0 = zero, 1 = printable, 2 = control, 3 = extended.
+#define C_ 2
+#define P_ 1
+#define E_ 3
+static const unsigned char byte_class[256] = {
+    0,  C_, C_, C_, C_, C_, C_, C_, C_, C_, C_, C_, C_, C_, C_, C_,
+    C_, C_, C_, C_, C_, C_, C_, C_, C_, C_, C_, C_, C_, C_, C_, C_,
+    P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_,
+    P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_,
+    P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_,
+    P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_,
+    P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_,
+    P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, P_, C_,
+    E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_,
+    E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_,
+    E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_,
+    E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_,
+    E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_,
+    E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_,
+    E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_,
+    E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_, E_
+};
+#undef C_
+#undef P_
+#undef E_
+
+#ifdef HXED_HAVE_SSE2
+// Counts zero, printable and extended bytes of data[0, len) (len multiple of 16).
+// Compare masks (-1 per hit) are subtracted into per-lane byte counters, which are
+// folded into 64-bit sums with psadbw before they can wrap (every 255 vectors).
+static void count_classes_sse2(const unsigned char *data, size_t len, size_t counts[4]) {
+    const __m128i low = _mm_set1_epi8(0x1F);
+    const __m128i high = _mm_set1_epi8(0x7F);
+    const __m128i nul = _mm_setzero_si128();
+    __m128i sum_zero = _mm_setzero_si128();
+    __m128i sum_print = _mm_setzero_si128();
+    __m128i sum_ext = _mm_setzero_si128();
+    size_t i = 0;
+
+    while (i < len) {
+        size_t stop = len - i > 255 * 16 ? i + 255 * 16 : len;
+        __m128i acc_zero = _mm_setzero_si128();
+        __m128i acc_print = _mm_setzero_si128();
+        __m128i acc_ext = _mm_setzero_si128();
+
+        for (; i < stop; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+            // Signed compares: bytes >= 0x80 are negative, so (v > 0x1F) && (v < 0x7F) is 0x20..0x7E.
+            __m128i print = _mm_and_si128(_mm_cmpgt_epi8(v, low), _mm_cmplt_epi8(v, high));
+
+            acc_zero = _mm_sub_epi8(acc_zero, _mm_cmpeq_epi8(v, nul));
+            acc_print = _mm_sub_epi8(acc_print, print);
+            acc_ext = _mm_sub_epi8(acc_ext, _mm_cmplt_epi8(v, nul));
+        }
+
+        sum_zero = _mm_add_epi64(sum_zero, _mm_sad_epu8(acc_zero, nul));
+        sum_print = _mm_add_epi64(sum_print, _mm_sad_epu8(acc_print, nul));
+        sum_ext = _mm_add_epi64(sum_ext, _mm_sad_epu8(acc_ext, nul));
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, sum_zero);
+    counts[0] += (size_t)(lanes[0] + lanes[1]);
+    _mm_storeu_si128((__m128i *)lanes, sum_print);
+    counts[1] += (size_t)(lanes[0] + lanes[1]);
+    _mm_storeu_si128((__m128i *)lanes, sum_ext);
+    counts[3] += (size_t)(lanes[0] + lanes[1]);
+}
+#endif
+
+// Counts the footer byte classes of a chunk. The vector path handles whole 16 byte
+// blocks, the class table handles the tail (and everything on non-SSE2 targets).
 void analyse(dump_analysis *analysis, unsigned char *data, size_t len) {
     if (!analysis || !data) return;
 
-    for (size_t i = 0; i < len; i++) {
-        unsigned char byte = data[i];
+    size_t counts[4] = {0};
+    size_t i = 0;
 
-        if (byte == 0x00) {
-            analysis->zero_bytes++;
-        }
-        else if (byte >= 0x20 && byte <= 0x7E) {
-            analysis->printable++;
-        }
-        else if ((byte <= 0x1F || byte == 0x7F) && byte != 0x00) {
-            analysis->control++;
-        }
-        else if (byte > 0x7F) {
-            analysis->extended_ascii++;
-        }
+    #ifdef HXED_HAVE_SSE2
+    size_t vector_len = len & ~(size_t)15;
+    if (vector_len > 0) {
+        count_classes_sse2(data, vector_len, counts);
+        // Whatever is neither zero, printable nor extended is a control byte.
+        counts[2] = vector_len - counts[0] - counts[1] - counts[3];
+        i = vector_len;
+    }
+    #endif
+
+    for (; i < len; i++) {
+        counts[byte_class[data[i]]]++;
     }
 
+    analysis->zero_bytes += counts[0];
+    analysis->printable += counts[1];
+    analysis->control += counts[2];
+    analysis->extended_ascii += counts[3];
     analysis->total_bytes += len;
 }
\ No newline at end of file
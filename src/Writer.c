@@ -0,0 +1,228 @@
+/*
+ * hxed - A modern hex dumper
+ * Copyright (c) 2026 Joshua Jallow
+ * Licensed under the MIT License.
+ * See LICENSE file in the project root for full license information.
+ */
+
+/* Output writer thread for the dump.
+ * How it works:
+ * - Rendered lines are collected in a fill buffer instead of being written one by one.
+ * - Once the fill buffer holds WRITER_BUFFER_SIZE bytes it is swapped into a ring of
+ *   WRITER_QUEUE_DEPTH slots, which a writer thread drains to the output sink (Sink.c).
+ *   Everything queued at wake-up goes out in one sink_writev call.
+ *   Rendering keeps going while the terminal or pipe catches up.
+ * - A full ring blocks the renderer (backpressure), so memory stays bounded no matter
+ *   how slow the reader on the other side is. All buffers are reserved up front with room
+ *   for one more line, so they never grow while rendering, and drained buffers are reused.
+ * - The first failed write is remembered. Later buffers are dropped, the renderer sees
+ *   the error on its next submit and stops; writer_close() returns the error.
+ * - Every WRITER_PROBE_INTERVAL submits the sink is checked for a closed pipe reader, so
+ *   a dump that produces little output (e.g. -se) still stops soon after the pager quits.
+ * - writer_close() always writes what was rendered so far, then joins the thread.
+ */
+
+#include "Writer.h"
+
+#include <errno.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+struct output_writer {
+    output_sink *sink;
+    text_buffer fill;                       // Buffer the renderer appends to
+    text_buffer slots[WRITER_QUEUE_DEPTH];  // Ring of buffers waiting for the writer thread
+    size_t head;                            // Next slot to write
+    size_t count;                           // Slots waiting, head .. head + count - 1
+    bool closing;
+    int error;                              // errno of the first failed write, 0 = none
+    size_t submits;                         // Submits since the last closed-reader check
+    #ifdef _WIN32
+    HANDLE thread;
+    CRITICAL_SECTION lock;
+    CONDITION_VARIABLE not_empty;
+    CONDITION_VARIABLE not_full;
+    #else
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    #endif
+};
+
+#ifdef _WIN32
+static void lock_writer(output_writer *w) { EnterCriticalSection(&w->lock); }
+static void unlock_writer(output_writer *w) { LeaveCriticalSection(&w->lock); }
+static void wait_not_empty(output_writer *w) { SleepConditionVariableCS(&w->not_empty, &w->lock, INFINITE); }
+static void wait_not_full(output_writer *w) { SleepConditionVariableCS(&w->not_full, &w->lock, INFINITE); }
+static void signal_not_empty(output_writer *w) { WakeConditionVariable(&w->not_empty); }
+static void signal_not_full(output_writer *w) { WakeConditionVariable(&w->not_full); }
+#else
+static void lock_writer(output_writer *w) { pthread_mutex_lock(&w->lock); }
+static void unlock_writer(output_writer *w) { pthread_mutex_unlock(&w->lock); }
+static void wait_not_empty(output_writer *w) { pthread_cond_wait(&w->not_empty, &w->lock); }
+static void wait_not_full(output_writer *w) { pthread_cond_wait(&w->not_full, &w->lock); }
+static void signal_not_empty(output_writer *w) { pthread_cond_signal(&w->not_empty); }
+static void signal_not_full(output_writer *w) { pthread_cond_signal(&w->not_full); }
+#endif
+
+// Writer thread: writes all queued slots without holding the lock. The renderer only
+// swaps into slots behind the queued ones, so they stay untouched until count drops.
+static void writer_loop(output_writer *w) {
+    lock_writer(w);
+    while (1) {
+        while (w->count == 0 && !w->closing) wait_not_empty(w);
+        if (w->count == 0) break;
+
+        text_buffer *batch[WRITER_QUEUE_DEPTH];
+        size_t batch_count = w->count;
+        for (size_t i = 0; i < batch_count; i++) batch[i] = &w->slots[(w->head + i) % WRITER_QUEUE_DEPTH];
+        bool failed = w->error != 0;
+        unlock_writer(w);
+
+        int error = failed ? 0 : sink_writev(w->sink, batch, batch_count);
+        for (size_t i = 0; i < batch_count; i++) batch[i]->len = 0;
+
+        lock_writer(w);
+        if (error && !w->error) w->error = error;
+        w->head = (w->head + batch_count) % WRITER_QUEUE_DEPTH;
+        w->count -= batch_count;
+        signal_not_full(w);
+    }
+    unlock_writer(w);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI writer_main(LPVOID param) {
+    writer_loop((output_writer *)param);
+    return 0;
+}
+#else
+static void *writer_main(void *param) {
+    writer_loop((output_writer *)param);
+    return NULL;
+}
+#endif
+
+static void reserve_buffer(text_buffer *buf) {
+    buf->cap = WRITER_BUFFER_SIZE + MAX_LINE_SIZE;
+    buf->data = malloc(buf->cap);
+    if (!buf->data) {
+        perror("Malloc failed for output writer");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Starts the writer thread for sink. Text already printed to the sink's stream is
+// flushed first, so it stays in front of the dump.
+output_writer *writer_open(output_sink *sink) {
+    output_writer *w = calloc(1, sizeof(*w));
+    if (!w) {
+        perror("Malloc failed for output writer");
+        exit(EXIT_FAILURE);
+    }
+    w->sink = sink;
+    w->error = sink_flush(sink);
+    reserve_buffer(&w->fill);
+    for (size_t i = 0; i < WRITER_QUEUE_DEPTH; i++) reserve_buffer(&w->slots[i]);
+
+    #ifdef _WIN32
+    InitializeCriticalSection(&w->lock);
+    InitializeConditionVariable(&w->not_empty);
+    InitializeConditionVariable(&w->not_full);
+    w->thread = CreateThread(NULL, 0, writer_main, w, 0, NULL);
+    if (!w->thread) {
+    #else
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->not_empty, NULL);
+    pthread_cond_init(&w->not_full, NULL);
+    if (pthread_create(&w->thread, NULL, writer_main, w) != 0) {
+    #endif
+        fprintf(stderr, "Error: could not start writer thread\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return w;
+}
+
+// Buffer to render into, e.g. as display_state.capture. Submits swap its contents,
+// so the pointer stays valid until writer_close().
+text_buffer *writer_buffer(output_writer *writer) {
+    return &writer->fill;
+}
+
+// Queues the fill buffer, waiting for a free slot while the ring is full.
+static void enqueue_fill(output_writer *w) {
+    lock_writer(w);
+    while (w->count == WRITER_QUEUE_DEPTH) wait_not_full(w);
+
+    size_t tail = (w->head + w->count) % WRITER_QUEUE_DEPTH;
+    text_buffer drained = w->slots[tail];
+    w->slots[tail] = w->fill;
+    w->fill = drained;
+    w->fill.len = 0;
+    w->count++;
+
+    signal_not_empty(w);
+    unlock_writer(w);
+}
+
+// Hands the fill buffer to the writer thread once it is large enough.
+// Returns false after a failed write or once the pipe reader is gone, the caller
+// should stop rendering.
+bool writer_submit(output_writer *writer) {
+    if (writer->fill.len >= WRITER_BUFFER_SIZE) enqueue_fill(writer);
+
+    bool closed = false;
+    if (++writer->submits >= WRITER_PROBE_INTERVAL) {
+        writer->submits = 0;
+        closed = sink_reader_closed(writer->sink);
+    }
+
+    lock_writer(writer);
+    if (closed && !writer->error) writer->error = EPIPE;
+    bool ok = writer->error == 0;
+    unlock_writer(writer);
+    return ok;
+}
+
+// Appends already rendered text, e.g. the per-chunk buffers of the --jobs renderer.
+void writer_write(output_writer *writer, const char *data, size_t len) {
+    text_buffer_append(&writer->fill, data, len);
+    if (writer->fill.len >= WRITER_BUFFER_SIZE) enqueue_fill(writer);
+}
+
+// Writes everything rendered so far, stops the thread and frees the writer.
+// Returns 0 or the errno of the first failed write.
+int writer_close(output_writer *writer) {
+    if (writer->fill.len > 0) enqueue_fill(writer);
+
+    lock_writer(writer);
+    writer->closing = true;
+    signal_not_empty(writer);
+    unlock_writer(writer);
+
+    #ifdef _WIN32
+    WaitForSingleObject(writer->thread, INFINITE);
+    CloseHandle(writer->thread);
+    DeleteCriticalSection(&writer->lock);
+    #else
+    pthread_join(writer->thread, NULL);
+    pthread_cond_destroy(&writer->not_full);
+    pthread_cond_destroy(&writer->not_empty);
+    pthread_mutex_destroy(&writer->lock);
+    #endif
+
+    int error = writer->error;
+    if (!error) error = sink_flush(writer->sink);
+
+    free(writer->fill.data);
+    for (size_t i = 0; i < WRITER_QUEUE_DEPTH; i++) free(writer->slots[i].data);
+    free(writer);
+    return error;
+}
@@ -7,10 +7,21 @@
 
 #include <stdlib.h>
 
+#include "Analysis.h"
 #include "Args.h"
 #include "Config.h"
+#include "Cpu.h"
+#include "Dedup.h"
+#include "Diff.h"
 #include "Display.h"
 #include "File.h"
+#include "Follow.h"
+#include "Hash.h"
+#include "Locate.h"
+#include "Pager.h"
+#include "Patch.h"
+#include "Snapshot.h"
+#include "StringScan.h"
 #include "Utils.h"
 
 #ifdef _WIN32
@@ -33,14 +44,37 @@ int main(int argc, char *argv[]) {
     // 2. Perform initial file existence and emptiness checks.
     check_file(option);
 
-    // 3. Execute the hex dump logic.
-    print_output(option);
+    // Lookup tables and CPU features, set up before any worker thread can read them.
+    init_entropy_table();
+    init_crc_tables();
+    detect_cpu_features();
+
+    // 3. Execute the hex dump logic (or one of the report modes).
+    if (option->make_patch) make_patch(option);
+    else if (option->apply_patch) apply_patch(option);
+    else if (option->diff_file) print_diff(option);
+    else if (option->follow) follow_file(option);
+    else if (option->tail_follow) tail_follow_file(option);
+    else if (option->snapshot_out) write_snapshot(option);
+    else if (option->since_snapshot) print_since(option);
+    else if (option->locate_needle) print_locate(option);
+    else if (option->stats_only) print_stats_only(option);
+    else if (option->entropy_map) print_entropy_map(option);
+    else if (option->segments) print_segments(option);
+    else if (option->strings) print_strings(option);
+    else if (option->dedup_report) print_dedup_report(option);
+    else if (pager_available(option)) run_pager(option);
+    else print_output(option);
+
+    // Patch modes write binary data, a trailing reset sequence would corrupt it.
+    bool binary_output = option->make_patch || option->apply_patch;
 
     // 4. Clean up allocated memory for options structure.
     free(option->search);
+    free(option->ranges);
     free(option);
     cleanup_colors();
-    print_color(RESET, true);
+    print_color(RESET, !binary_output);
 
     return EXIT_SUCCESS;
 }